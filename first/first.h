@@ -61,6 +61,11 @@ readLine_char_firstD* readLine(FILE *fp, readLine_char_firstD *line, unsigned in
 	line = readLine_free(line);
 */
 
+// -std=c11 hides the POSIX.1-2008 calls the JIT cache relies on, such as mkdtemp
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
@@ -670,6 +675,47 @@ readLine_char_firstD* readLine(FILE *fp, readLine_char_firstD *line, unsigned in
 #include <stdbool.h>
 #include <string.h>
 #include <strings.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdarg.h>
+#include <dlfcn.h>
+#include <errno.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define PLANE_KERNELS_X86
+#endif
+#if defined(__GNUC__)
+#define BYTECODE_COMPUTED_GOTO
+#endif
+
+extern char **environ;
+
+#define BLOCK_WORDS 64
+#define PROBE_BLOCK SIZE_MAX
+#define NO_OUTPUT_SLOT SIZE_MAX
+#define BYTECODE_HEADER_WORDS 6
+#define MAX_NUM_OF_SELECT_BITS 64
+#define JIT_CACHE_DIRECTORY "circuit-simulator"
+#define JIT_DEFAULT_COMPILER "cc"
+#define MAX_NUM_OF_PROBE_ROWS 64
+#define NETLIST_IMAGE_MAGIC "CIRCNET"
+#define NETLIST_IMAGE_VERSION 4
+#define NETLIST_IMAGE_INPUTVAR_FIRST 1
+#define SEARCH_CHUNKS_PER_WORKER 8
+#define MIN_CANDIDATES_PER_WORKER 16
+#define MAX_NUM_OF_SEARCH_WORKERS 64
+#define MAX_NUM_OF_CACHED_WORDS (1 << 24)
+#define SAT_UNASSIGNED 2
+#define SAT_NO_REASON SIZE_MAX
+#define SAT_RESTART_BASE 100
+#define SAT_ACTIVITY_DECAY 0.95
 
 typedef enum gate_type {
 	GATE_COUNT = 6,
@@ -682,19 +728,58 @@ typedef enum gate_type {
 	OTHER
 } gate_type;
 
+typedef enum opcode {
+	OP_FAIL,
+	OP_OR,
+	OP_AND,
+	OP_XOR,
+	OP_NOT,
+	OP_DECODER,
+	OP_MULTIPLEXER
+} opcode;
+
+struct signal_table;
 struct input_output;
 struct gate;
+struct compiled_gate;
+struct compiled_netlist;
+struct jit_source;
+struct jit_program;
+struct jit_block;
+struct bytecode;
 struct circuit;
 struct input;
 struct input_value;
 struct output;
 struct output_value;
 struct outcomes;
+struct netlist;
+struct token;
+struct tokenizer;
+struct netlist_image_header;
+struct assignment_iterator;
+struct signal_cache;
+struct search_worker;
+struct search_pool;
+struct sat_solver;
+
+typedef struct signal_table {
+	char **names;
+	bool *defined;
+	size_t *buckets;
+	size_t num_of_signals;
+	size_t max_num_of_signals;
+	size_t num_of_buckets;
+} signal_table;
 
 typedef struct input_output {
 	char **inputs;
 	char **outputs;
 	char **selectors;
+	size_t *input_ids;
+	size_t *output_ids;
+	size_t *selector_ids;
+	size_t *output_slots;
 	size_t num_of_inputs;
 	size_t num_of_outputs;
 	size_t num_of_selectors;
@@ -705,13 +790,77 @@ typedef struct gate {
 	input_output *input_output;
 } gate;
 
+typedef struct compiled_gate {
+	const size_t *input_ids;
+	const size_t *selector_ids;
+	const size_t *output_ids;
+	const size_t *output_slots;
+	size_t num_of_inputs;
+	size_t num_of_selectors;
+	size_t num_of_outputs;
+} compiled_gate;
+
+typedef struct compiled_netlist {
+	size_t *gate_indices;
+	size_t *positions;
+	size_t *levels;
+	size_t *level_offsets;
+	size_t *num_of_inputs;
+	size_t *num_of_selectors;
+	size_t *num_of_outputs;
+	size_t *pin_offsets;
+	size_t *pins;
+	size_t *output_slots;
+	size_t num_of_gates;
+	size_t num_of_levels;
+	size_t num_of_pins;
+	size_t num_of_signals;
+} compiled_netlist;
+
+typedef int (*jit_block_function)(uint64_t *signal_values, size_t num_of_block_words, size_t num_of_words, const size_t *code, int (*publish)(void *context, size_t index_of_output, const uint64_t *plane), void *context);
+
+typedef struct jit_source {
+	char *text;
+	size_t length;
+	size_t max_length;
+} jit_source;
+
+typedef struct jit_program {
+	void *handle;
+	jit_block_function function;
+	size_t hash;
+} jit_program;
+
+typedef struct jit_block {
+	struct output_value *output_value;
+	size_t index_of_block;
+} jit_block;
+
+typedef struct bytecode {
+	size_t *code;
+	size_t *instruction_offsets;
+	size_t *other_gate_offsets;
+	size_t *other_gate_opcodes;
+	size_t *other_gate_indices;
+	compiled_netlist *compiled_netlist;
+	jit_program *jit_program;
+	size_t num_of_words;
+	size_t num_of_gates;
+	size_t num_of_other_gates;
+} bytecode;
+
 typedef struct circuit {
 	gate **gates;
+	signal_table *signals;
+	compiled_netlist *compiled_netlist;
+	bytecode *bytecode;
+	jit_program *jit_program;
 	size_t *other_gate_indices;
-	size_t *other_gate_permutations;
+	gate_type *feasible_gate_types;
+	size_t *num_of_feasible_gate_types;
 	size_t num_of_gates;
+	size_t max_num_of_gates;
 	size_t num_of_other_gates;
-	size_t num_of_other_gate_permutations;
 } circuit;
 
 typedef struct input {
@@ -719,65 +868,172 @@ typedef struct input {
 	size_t value;
 } input;
 
+typedef struct outcomes {
+	size_t *outcomes;
+	size_t *positions;
+	size_t num_of_outcomes;
+} outcomes;
+
 typedef struct input_value {
 	input **inputs;
+	outcomes **cached_outcomes;
+	uint64_t *signal_values;
+	uint64_t *input_words;
+	uint64_t *scratch_planes;
+	uint64_t *step_planes;
+	uint64_t *probe_words;
+	bool *is_signal_dirty;
+	size_t num_of_signals;
+	size_t num_of_blocks;
+	size_t num_of_block_words;
+	size_t num_of_active_words;
 	size_t original_num_of_inputs;
-	size_t current_num_of_inputs;
-	size_t max_num_of_inputs;
+	size_t num_of_inputs;
+	size_t num_of_cached_outcomes;
+	size_t num_of_step_planes;
+	size_t stepped_block;
+	bool first;
 } input_value;
 
 typedef struct output {
 	char *output;
-	size_t *values;
+	uint64_t *words;
 	size_t num_of_values;
+	size_t num_of_words;
 } output;
 
 typedef struct output_value {
 	output **outputs;
 	output **gen_outputs;
+	uint64_t *probe_words;
+	size_t *probe_rows;
+	uint64_t probe_mask;
+	size_t num_of_probe_rows;
+	size_t mismatch_row;
 	size_t num_of_outputs;
+	size_t num_of_block_words;
 } output_value;
 
-typedef struct outcomes {
-	size_t *outcomes;
-	size_t num_of_outcomes;
-} outcomes;
+typedef struct netlist {
+	input_value *input_value;
+	output_value *output_value;
+	circuit *circuit;
+} netlist;
 
-char** copy_array_of_strings(input **source, size_t current_num_of_strings, size_t max_num_of_strings) {
-	char **copy = malloc(sizeof(char*) * max_num_of_strings);
-	for (size_t i = 0; i < max_num_of_strings; i++) {
-		if (i < current_num_of_strings) {
-			copy[i] = malloc(sizeof(char) * (strlen(source[i]->input) + 1));
-			strcpy(copy[i], source[i]->input);
-		} else {
-			copy[i] = NULL;
-		}
-	}
-	return copy;
-}
+typedef struct token {
+	const char *start;
+	size_t length;
+} token;
 
-void add_string_to_array(char *str, char **arr, size_t current_num_of_strings) {
-	arr[current_num_of_strings] = malloc(sizeof(char) * (strlen(str) + 1));
-	strcpy(arr[current_num_of_strings], str);
-	return;
-}
+typedef struct tokenizer {
+	char *data;
+	token *tokens;
+	size_t size;
+	size_t position;
+	size_t num_of_tokens;
+	size_t max_num_of_tokens;
+} tokenizer;
 
-char** free_array_of_strings(char **arr, size_t num_of_strings) {
-	for (size_t i = 0; i < num_of_strings; i++) {
-		arr[i] = Free(arr[i]);
-	}
-	arr = Free(arr);
-	return NULL;
-}
+typedef struct netlist_image_header {
+	char magic[8];
+	uint64_t version;
+	uint64_t flags;
+	uint64_t num_of_inputs;
+	uint64_t num_of_outputs;
+	uint64_t num_of_signals;
+	uint64_t num_of_gates;
+	uint64_t num_of_pins;
+	uint64_t num_of_words;
+	uint64_t signal_names_size;
+	uint64_t output_names_size;
+} netlist_image_header;
 
-bool array_contains_string(char *str, char **arr, size_t num_of_strings) {
-	for (size_t i = 0; i < num_of_strings; i++) {
-		if (strcmp(arr[i], str) == 0) {
-			return true;
-		}
-	}
-	return false;
-}
+typedef struct assignment_iterator {
+	gate **gates;
+	size_t *other_gate_indices;
+	gate_type *feasible_gate_types;
+	size_t *num_of_feasible_gate_types;
+	size_t *digits;
+	size_t num_of_other_gates;
+	size_t candidate;
+	size_t last_candidate;
+} assignment_iterator;
+
+typedef struct signal_cache {
+	uint64_t *values;
+	gate_type *block_types;
+	size_t *first_stale_gates;
+	bool *is_gate_dirty;
+	bool *is_signal_dirty;
+	size_t *other_gate_indices;
+	size_t *other_gate_positions;
+	size_t *output_signal_ids;
+	compiled_netlist *compiled_netlist;
+	size_t num_of_blocks;
+	size_t num_of_signals;
+	size_t num_of_block_words;
+	size_t num_of_gates;
+	size_t num_of_other_gates;
+	size_t num_of_outputs;
+} signal_cache;
+
+typedef struct search_worker {
+	struct search_pool *pool;
+	gate **gates;
+	bytecode *bytecode;
+	assignment_iterator *assignment_iterator;
+	signal_cache *signal_cache;
+	input_value *input_value;
+	output_value *output_value;
+	size_t *chunks;
+	size_t head;
+	size_t tail;
+	pthread_mutex_t lock;
+	pthread_t thread;
+} search_worker;
+
+typedef struct search_pool {
+	circuit *circuit;
+	search_worker **workers;
+	_Atomic size_t best_candidate;
+	size_t num_of_workers;
+	size_t num_of_candidates;
+	size_t num_of_chunks;
+	size_t chunk_size;
+} search_pool;
+
+typedef struct sat_solver {
+	size_t *literals;
+	size_t *clause_starts;
+	size_t *clause_sizes;
+	size_t **watches;
+	size_t *num_of_watches;
+	size_t *max_num_of_watches;
+	uint8_t *values;
+	uint8_t *phases;
+	uint8_t *model;
+	bool *seen;
+	size_t *levels;
+	size_t *reasons;
+	size_t *trail;
+	size_t *trail_limits;
+	size_t *learnt;
+	double *activities;
+	size_t *heap;
+	size_t *heap_positions;
+	double activity_increment;
+	size_t num_of_vars;
+	size_t max_num_of_vars;
+	size_t num_of_clauses;
+	size_t max_num_of_clauses;
+	size_t num_of_literals;
+	size_t max_num_of_literals;
+	size_t trail_size;
+	size_t num_of_levels;
+	size_t propagation_head;
+	size_t heap_size;
+	bool is_unsat;
+} sat_solver;
 
 size_t logarithm_base_2_floored(size_t number) {
 	size_t result = 0;
@@ -791,6 +1047,29 @@ size_t logarithm_base_2_floored(size_t number) {
 	return result - ONE;
 }
 
+size_t get_num_of_block_words(size_t num_of_values) {
+	size_t num_of_words = (num_of_values + 63) / 64;
+	if (num_of_words > BLOCK_WORDS) {
+		return BLOCK_WORDS;
+	}
+	return num_of_words;
+}
+
+size_t get_num_of_padded_words(size_t num_of_values) {
+	size_t num_of_words = (num_of_values + 63) / 64;
+	size_t num_of_block_words = get_num_of_block_words(num_of_values);
+	return ((num_of_words + num_of_block_words - 1) / num_of_block_words) * num_of_block_words;
+}
+
+uint64_t get_word_mask(size_t num_of_values, size_t index_of_word) {
+	size_t ONE = 1;
+	size_t num_of_rows = num_of_values - index_of_word * 64;
+	if (num_of_rows >= 64) {
+		return UINT64_MAX;
+	}
+	return (ONE << num_of_rows) - ONE;
+}
+
 size_t pows(size_t base, size_t exponent) {
 	if (exponent == 0) {
 		return 1;
@@ -802,11 +1081,35 @@ size_t pows(size_t base, size_t exponent) {
 	return product;
 }
 
+size_t signal_table_hash(const char *name, size_t length) {
+	size_t hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < length; i++) {
+		hash ^= (unsigned char) name[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+signal_table* signal_table_constructor() {
+	signal_table *new_signal_table = malloc(sizeof(signal_table));
+	new_signal_table->names = NULL;
+	new_signal_table->defined = NULL;
+	new_signal_table->buckets = NULL;
+	new_signal_table->num_of_signals = 0;
+	new_signal_table->max_num_of_signals = 0;
+	new_signal_table->num_of_buckets = 0;
+	return new_signal_table;
+}
+
 input_output* input_output_constructor() {
 	input_output *new_input_output = malloc(sizeof(input_output));
 	new_input_output->inputs = NULL;
 	new_input_output->outputs = NULL;
 	new_input_output->selectors = NULL;
+	new_input_output->input_ids = NULL;
+	new_input_output->output_ids = NULL;
+	new_input_output->selector_ids = NULL;
+	new_input_output->output_slots = NULL;
 	new_input_output->num_of_inputs = 0;
 	new_input_output->num_of_outputs = 0;
 	new_input_output->num_of_selectors = 0;
@@ -820,14 +1123,70 @@ gate* gate_constructor() {
 	return new_gate;
 }
 
+compiled_netlist* compiled_netlist_constructor() {
+	compiled_netlist *new_compiled_netlist = malloc(sizeof(compiled_netlist));
+	new_compiled_netlist->gate_indices = NULL;
+	new_compiled_netlist->positions = NULL;
+	new_compiled_netlist->levels = NULL;
+	new_compiled_netlist->level_offsets = NULL;
+	new_compiled_netlist->num_of_inputs = NULL;
+	new_compiled_netlist->num_of_selectors = NULL;
+	new_compiled_netlist->num_of_outputs = NULL;
+	new_compiled_netlist->pin_offsets = NULL;
+	new_compiled_netlist->pins = NULL;
+	new_compiled_netlist->output_slots = NULL;
+	new_compiled_netlist->num_of_gates = 0;
+	new_compiled_netlist->num_of_levels = 0;
+	new_compiled_netlist->num_of_pins = 0;
+	new_compiled_netlist->num_of_signals = 0;
+	return new_compiled_netlist;
+}
+
+jit_source* jit_source_constructor() {
+	jit_source *new_jit_source = malloc(sizeof(jit_source));
+	new_jit_source->max_length = 4096;
+	new_jit_source->text = malloc(sizeof(char) * new_jit_source->max_length);
+	new_jit_source->text[0] = '\0';
+	new_jit_source->length = 0;
+	return new_jit_source;
+}
+
+jit_program* jit_program_constructor() {
+	jit_program *new_jit_program = malloc(sizeof(jit_program));
+	new_jit_program->handle = NULL;
+	new_jit_program->function = NULL;
+	new_jit_program->hash = 0;
+	return new_jit_program;
+}
+
+bytecode* bytecode_constructor() {
+	bytecode *new_bytecode = malloc(sizeof(bytecode));
+	new_bytecode->code = NULL;
+	new_bytecode->instruction_offsets = NULL;
+	new_bytecode->other_gate_offsets = NULL;
+	new_bytecode->other_gate_opcodes = NULL;
+	new_bytecode->other_gate_indices = NULL;
+	new_bytecode->compiled_netlist = NULL;
+	new_bytecode->jit_program = NULL;
+	new_bytecode->num_of_words = 0;
+	new_bytecode->num_of_gates = 0;
+	new_bytecode->num_of_other_gates = 0;
+	return new_bytecode;
+}
+
 circuit* circuit_constructor() {
 	circuit *new_circuit = malloc(sizeof(circuit));
 	new_circuit->gates = NULL;
+	new_circuit->signals = signal_table_constructor();
+	new_circuit->compiled_netlist = NULL;
+	new_circuit->bytecode = NULL;
+	new_circuit->jit_program = NULL;
 	new_circuit->other_gate_indices = NULL;
-	new_circuit->other_gate_permutations = NULL;
+	new_circuit->feasible_gate_types = NULL;
+	new_circuit->num_of_feasible_gate_types = NULL;
 	new_circuit->num_of_gates = 0;
+	new_circuit->max_num_of_gates = 0;
 	new_circuit->num_of_other_gates = 0;
-	new_circuit->num_of_other_gate_permutations = 0;
 	return new_circuit;
 }
 
@@ -841,17 +1200,32 @@ input* input_constructor() {
 input_value* input_value_constructor() {
 	input_value *new_input_value = malloc(sizeof(input_value));
 	new_input_value->inputs = NULL;
+	new_input_value->signal_values = NULL;
+	new_input_value->input_words = NULL;
+	new_input_value->scratch_planes = NULL;
+	new_input_value->step_planes = NULL;
+	new_input_value->probe_words = NULL;
+	new_input_value->cached_outcomes = NULL;
+	new_input_value->is_signal_dirty = NULL;
+	new_input_value->num_of_signals = 0;
+	new_input_value->num_of_blocks = 0;
+	new_input_value->num_of_block_words = 0;
+	new_input_value->num_of_active_words = 0;
 	new_input_value->original_num_of_inputs = 0;
-	new_input_value->current_num_of_inputs = 0;
-	new_input_value->max_num_of_inputs = 0;
+	new_input_value->num_of_inputs = 0;
+	new_input_value->num_of_cached_outcomes = 0;
+	new_input_value->num_of_step_planes = 0;
+	new_input_value->stepped_block = SIZE_MAX;
+	new_input_value->first = false;
 	return new_input_value;
 }
 
 output* output_constructor() {
 	output *new_output = malloc(sizeof(output));
 	new_output->output = NULL;
-	new_output->values = NULL;
+	new_output->words = NULL;
 	new_output->num_of_values = 0;
+	new_output->num_of_words = 0;
 	return new_output;
 }
 
@@ -859,17 +1233,112 @@ output_value* output_value_constructor() {
 	output_value *new_output_value = malloc(sizeof(output_value));
 	new_output_value->outputs = NULL;
 	new_output_value->gen_outputs = NULL;
+	new_output_value->probe_words = NULL;
+	new_output_value->probe_rows = NULL;
+	new_output_value->probe_mask = 0;
+	new_output_value->num_of_probe_rows = 0;
+	new_output_value->mismatch_row = SIZE_MAX;
 	new_output_value->num_of_outputs = 0;
+	new_output_value->num_of_block_words = 0;
 	return new_output_value;
 }
 
 outcomes* outcomes_constructor() {
 	outcomes *new_outcomes = malloc(sizeof(outcomes));
 	new_outcomes->outcomes = NULL;
+	new_outcomes->positions = NULL;
 	new_outcomes->num_of_outcomes = 0;
 	return new_outcomes;
 }
 
+netlist* netlist_constructor() {
+	netlist *new_netlist = malloc(sizeof(netlist));
+	new_netlist->input_value = input_value_constructor();
+	new_netlist->output_value = output_value_constructor();
+	new_netlist->circuit = circuit_constructor();
+	return new_netlist;
+}
+
+tokenizer* tokenizer_constructor() {
+	tokenizer *new_tokenizer = malloc(sizeof(tokenizer));
+	new_tokenizer->data = NULL;
+	new_tokenizer->tokens = NULL;
+	new_tokenizer->size = 0;
+	new_tokenizer->position = 0;
+	new_tokenizer->num_of_tokens = 0;
+	new_tokenizer->max_num_of_tokens = 0;
+	return new_tokenizer;
+}
+
+sat_solver* sat_solver_constructor() {
+	sat_solver *new_sat_solver = malloc(sizeof(sat_solver));
+	new_sat_solver->literals = NULL;
+	new_sat_solver->clause_starts = NULL;
+	new_sat_solver->clause_sizes = NULL;
+	new_sat_solver->watches = NULL;
+	new_sat_solver->num_of_watches = NULL;
+	new_sat_solver->max_num_of_watches = NULL;
+	new_sat_solver->values = NULL;
+	new_sat_solver->phases = NULL;
+	new_sat_solver->model = NULL;
+	new_sat_solver->seen = NULL;
+	new_sat_solver->levels = NULL;
+	new_sat_solver->reasons = NULL;
+	new_sat_solver->trail = NULL;
+	new_sat_solver->trail_limits = NULL;
+	new_sat_solver->learnt = NULL;
+	new_sat_solver->activities = NULL;
+	new_sat_solver->heap = NULL;
+	new_sat_solver->heap_positions = NULL;
+	new_sat_solver->activity_increment = 1;
+	new_sat_solver->num_of_vars = 0;
+	new_sat_solver->max_num_of_vars = 0;
+	new_sat_solver->num_of_clauses = 0;
+	new_sat_solver->max_num_of_clauses = 0;
+	new_sat_solver->num_of_literals = 0;
+	new_sat_solver->max_num_of_literals = 0;
+	new_sat_solver->trail_size = 0;
+	new_sat_solver->num_of_levels = 0;
+	new_sat_solver->propagation_head = 0;
+	new_sat_solver->heap_size = 0;
+	new_sat_solver->is_unsat = false;
+	return new_sat_solver;
+}
+
+assignment_iterator* assignment_iterator_constructor(gate **gates, circuit *circuit) {
+	assignment_iterator *new_assignment_iterator = malloc(sizeof(assignment_iterator));
+	new_assignment_iterator->gates = gates;
+	new_assignment_iterator->other_gate_indices = circuit->other_gate_indices;
+	new_assignment_iterator->feasible_gate_types = circuit->feasible_gate_types;
+	new_assignment_iterator->num_of_feasible_gate_types = circuit->num_of_feasible_gate_types;
+	new_assignment_iterator->digits = calloc(circuit->num_of_other_gates, sizeof(size_t));
+	new_assignment_iterator->num_of_other_gates = circuit->num_of_other_gates;
+	new_assignment_iterator->candidate = 0;
+	new_assignment_iterator->last_candidate = 0;
+	return new_assignment_iterator;
+}
+
+signal_table* signal_table_free(signal_table *signal_table, bool keep_outer) {
+	if (signal_table == NULL) {
+		return NULL;
+	}
+	size_t num_of_signals = signal_table->num_of_signals;
+	for (size_t i = 0; i < num_of_signals; i++) {
+		signal_table->names[i] = Free(signal_table->names[i]);
+	}
+	signal_table->names = Free(signal_table->names);
+	signal_table->defined = Free(signal_table->defined);
+	signal_table->buckets = Free(signal_table->buckets);
+	if (!keep_outer) {
+		signal_table = Free(signal_table);
+		return NULL;
+	}
+	signal_table->num_of_signals = 0;
+	signal_table->max_num_of_signals = 0;
+	signal_table->num_of_buckets = 0;
+	return NULL;
+}
+
 input_output* input_output_free(input_output *input_output, bool keep_outer) {
 	if (input_output == NULL) {
 		return NULL;
@@ -889,6 +1358,10 @@ input_output* input_output_free(input_output *input_output, bool keep_outer) {
 		input_output->selectors[i] = Free(input_output->selectors[i]);
 	}
 	input_output->selectors = Free(input_output->selectors);
+	input_output->input_ids = Free(input_output->input_ids);
+	input_output->output_ids = Free(input_output->output_ids);
+	input_output->selector_ids = Free(input_output->selector_ids);
+	input_output->output_slots = Free(input_output->output_slots);
 	if (!keep_outer) {
 		input_output = Free(input_output);
 		return NULL;
@@ -913,6 +1386,83 @@ gate* gate_free(gate *gate, bool keep_outer) {
 	return NULL;
 }
 
+compiled_netlist* compiled_netlist_free(compiled_netlist *compiled_netlist, bool keep_outer) {
+	if (compiled_netlist == NULL) {
+		return NULL;
+	}
+	// every array is carved out of the block that starts at gate_indices
+	compiled_netlist->gate_indices = Free(compiled_netlist->gate_indices);
+	compiled_netlist->positions = NULL;
+	compiled_netlist->levels = NULL;
+	compiled_netlist->level_offsets = NULL;
+	compiled_netlist->num_of_inputs = NULL;
+	compiled_netlist->num_of_selectors = NULL;
+	compiled_netlist->num_of_outputs = NULL;
+	compiled_netlist->pin_offsets = NULL;
+	compiled_netlist->pins = NULL;
+	compiled_netlist->output_slots = NULL;
+	if (!keep_outer) {
+		compiled_netlist = Free(compiled_netlist);
+		return NULL;
+	}
+	compiled_netlist->num_of_gates = 0;
+	compiled_netlist->num_of_levels = 0;
+	compiled_netlist->num_of_pins = 0;
+	return NULL;
+}
+
+jit_source* jit_source_free(jit_source *jit_source, bool keep_outer) {
+	if (jit_source == NULL) {
+		return NULL;
+	}
+	jit_source->text = Free(jit_source->text);
+	if (!keep_outer) {
+		jit_source = Free(jit_source);
+		return NULL;
+	}
+	jit_source->length = 0;
+	jit_source->max_length = 0;
+	return NULL;
+}
+
+jit_program* jit_program_free(jit_program *jit_program, bool keep_outer) {
+	if (jit_program == NULL) {
+		return NULL;
+	}
+	if (jit_program->handle != NULL) {
+		dlclose(jit_program->handle);
+	}
+	jit_program->handle = NULL;
+	jit_program->function = NULL;
+	if (!keep_outer) {
+		jit_program = Free(jit_program);
+		return NULL;
+	}
+	jit_program->hash = 0;
+	return NULL;
+}
+
+bytecode* bytecode_free(bytecode *bytecode, bool keep_outer) {
+	if (bytecode == NULL) {
+		return NULL;
+	}
+	bytecode->code = Free(bytecode->code);
+	bytecode->instruction_offsets = Free(bytecode->instruction_offsets);
+	bytecode->other_gate_offsets = Free(bytecode->other_gate_offsets);
+	bytecode->other_gate_opcodes = Free(bytecode->other_gate_opcodes);
+	bytecode->other_gate_indices = NULL;
+	bytecode->compiled_netlist = NULL;
+	bytecode->jit_program = NULL;
+	if (!keep_outer) {
+		bytecode = Free(bytecode);
+		return NULL;
+	}
+	bytecode->num_of_words = 0;
+	bytecode->num_of_gates = 0;
+	bytecode->num_of_other_gates = 0;
+	return NULL;
+}
+
 circuit* circuit_free(circuit *circuit, bool keep_outer) {
 	if (circuit == NULL) {
 		return NULL;
@@ -922,15 +1472,21 @@ circuit* circuit_free(circuit *circuit, bool keep_outer) {
 		circuit->gates[i] = gate_free(circuit->gates[i], false);
 	}
 	circuit->gates = Free(circuit->gates);
+	circuit->signals = signal_table_free(circuit->signals, false);
+	circuit->bytecode = bytecode_free(circuit->bytecode, false);
+	circuit->jit_program = jit_program_free(circuit->jit_program, false);
+	circuit->compiled_netlist = compiled_netlist_free(circuit->compiled_netlist, false);
 	circuit->other_gate_indices = Free(circuit->other_gate_indices);
-	circuit->other_gate_permutations = Free(circuit->other_gate_permutations);
+	circuit->feasible_gate_types = Free(circuit->feasible_gate_types);
+	circuit->num_of_feasible_gate_types = Free(circuit->num_of_feasible_gate_types);
 	if (!keep_outer) {
 		circuit = Free(circuit);
 		return NULL;
 	}
+	circuit->signals = signal_table_constructor();
 	circuit->num_of_gates = 0;
+	circuit->max_num_of_gates = 0;
 	circuit->num_of_other_gates = 0;
-	circuit->num_of_other_gate_permutations = 0;
 	return NULL;
 }
 
@@ -947,22 +1503,54 @@ input* input_free(input *input, bool keep_outer) {
 	return NULL;
 }
 
+outcomes* outcomes_free(outcomes *outcomes, bool keep_outer) {
+	if (outcomes == NULL) {
+		return NULL;
+	}
+	outcomes->outcomes = Free(outcomes->outcomes);
+	outcomes->positions = Free(outcomes->positions);
+	if (!keep_outer) {
+		outcomes = Free(outcomes);
+		return NULL;
+	}
+	outcomes->num_of_outcomes = 0;
+	return NULL;
+}
+
 input_value* input_value_free(input_value *input_value, bool keep_outer) {
 	if (input_value == NULL) {
 		return NULL;
 	}
-	size_t num_of_inputs = input_value->max_num_of_inputs;
+	size_t num_of_inputs = input_value->num_of_inputs;
 	for (size_t i = 0; i < num_of_inputs; i++) {
 		input_value->inputs[i] = input_free(input_value->inputs[i], false);
 	}
 	input_value->inputs = Free(input_value->inputs);
+	size_t num_of_cached_outcomes = input_value->num_of_cached_outcomes;
+	for (size_t i = 0; i < num_of_cached_outcomes; i++) {
+		input_value->cached_outcomes[i] = outcomes_free(input_value->cached_outcomes[i], false);
+	}
+	input_value->cached_outcomes = Free(input_value->cached_outcomes);
+	input_value->signal_values = Free(input_value->signal_values);
+	input_value->input_words = Free(input_value->input_words);
+	input_value->scratch_planes = Free(input_value->scratch_planes);
+	input_value->step_planes = Free(input_value->step_planes);
+	input_value->probe_words = Free(input_value->probe_words);
+	input_value->is_signal_dirty = Free(input_value->is_signal_dirty);
 	if (!keep_outer) {
 		input_value = Free(input_value);
 		return NULL;
 	}
 	input_value->original_num_of_inputs = 0;
-	input_value->current_num_of_inputs = 0;
-	input_value->max_num_of_inputs = 0;
+	input_value->num_of_inputs = 0;
+	input_value->num_of_cached_outcomes = 0;
+	input_value->num_of_step_planes = 0;
+	input_value->num_of_signals = 0;
+	input_value->num_of_blocks = 0;
+	input_value->num_of_block_words = 0;
+	input_value->num_of_active_words = 0;
+	input_value->stepped_block = SIZE_MAX;
+	input_value->first = false;
 	return NULL;
 }
 
@@ -971,12 +1559,13 @@ output* output_free(output *output, bool keep_outer) {
 		return NULL;
 	}
 	output->output = Free(output->output);
-	output->values = Free(output->values);
+	output->words = Free(output->words);
 	if (!keep_outer) {
 		output = Free(output);
 		return NULL;
 	}
 	output->num_of_values = 0;
+	output->num_of_words = 0;
 	return NULL;
 }
 
@@ -991,71 +1580,270 @@ output_value* output_value_free(output_value *output_value, bool keep_outer) {
 	}
 	output_value->outputs = Free(output_value->outputs);
 	output_value->gen_outputs = Free(output_value->gen_outputs);
+	output_value->probe_words = Free(output_value->probe_words);
+	output_value->probe_rows = Free(output_value->probe_rows);
 	if (!keep_outer) {
 		output_value = Free(output_value);
 		return NULL;
 	}
+	output_value->probe_mask = 0;
+	output_value->num_of_probe_rows = 0;
+	output_value->mismatch_row = SIZE_MAX;
 	output_value->num_of_outputs = 0;
+	output_value->num_of_block_words = 0;
 	return NULL;
 }
 
-outcomes* outcomes_free(outcomes *outcomes, bool keep_outer) {
-	if (outcomes == NULL) {
+netlist* netlist_free(netlist *netlist, bool keep_outer) {
+	if (netlist == NULL) {
 		return NULL;
 	}
-	outcomes->outcomes = Free(outcomes->outcomes);
+	netlist->input_value = input_value_free(netlist->input_value, false);
+	netlist->output_value = output_value_free(netlist->output_value, false);
+	netlist->circuit = circuit_free(netlist->circuit, false);
 	if (!keep_outer) {
-		outcomes = Free(outcomes);
+		netlist = Free(netlist);
 		return NULL;
 	}
-	outcomes->num_of_outcomes = 0;
+	netlist->input_value = input_value_constructor();
+	netlist->output_value = output_value_constructor();
+	netlist->circuit = circuit_constructor();
 	return NULL;
 }
 
-size_t gen_num_of_other_gate_permutations(size_t gate_count, size_t number_other_gates) {
-	size_t result = gate_count;
-	if (number_other_gates == 0) {
-		return 0;
+tokenizer* tokenizer_free(tokenizer *tokenizer, bool keep_outer) {
+	if (tokenizer == NULL) {
+		return NULL;
 	}
-	if (number_other_gates == 1) {
-		return result;
+	if (tokenizer->data != NULL) {
+		munmap(tokenizer->data, tokenizer->size);
+		tokenizer->data = NULL;
 	}
-	for (size_t i = 0; i < number_other_gates - 1; i++) {
-		result++;
-		result *= gate_count;
+	tokenizer->tokens = Free(tokenizer->tokens);
+	if (!keep_outer) {
+		tokenizer = Free(tokenizer);
+		return NULL;
 	}
-	return result;
+	tokenizer->size = 0;
+	tokenizer->position = 0;
+	tokenizer->num_of_tokens = 0;
+	tokenizer->max_num_of_tokens = 0;
+	return NULL;
 }
 
-void gen_other_gate_permutations(circuit *circuit) {
-	size_t ONE = 1;
-	size_t number_other_gates = circuit->num_of_other_gates;
-	for (size_t i = 0; i < number_other_gates; i++) {
-		circuit->gates[circuit->other_gate_indices[i]]->type = OR;
-	}
-	size_t gate_count = GATE_COUNT;
-	size_t number_of_permutations = gen_num_of_other_gate_permutations(gate_count, number_other_gates);
-	circuit->num_of_other_gate_permutations = number_of_permutations;
-	circuit->other_gate_permutations = malloc(sizeof(size_t) * number_of_permutations);
-	size_t curr_gate_index = number_other_gates - ONE;
-	size_t last_index = 0;
-	size_t j = 0;
-	circuit->other_gate_permutations[0] = curr_gate_index;
-	while (true) {
-		j = last_index + ONE;
-		for (size_t k = 0; k < gate_count - ONE; k++) {
-			for (size_t i = 0; i <= last_index; i++) {
-				circuit->other_gate_permutations[j] = circuit->other_gate_permutations[i];
-				j++;
-			}
+sat_solver* sat_solver_free(sat_solver *sat_solver, bool keep_outer) {
+	if (sat_solver == NULL) {
+		return NULL;
+	}
+	size_t num_of_watch_lists = sat_solver->num_of_vars * 2;
+	for (size_t i = 0; i < num_of_watch_lists; i++) {
+		sat_solver->watches[i] = Free(sat_solver->watches[i]);
+	}
+	sat_solver->literals = Free(sat_solver->literals);
+	sat_solver->clause_starts = Free(sat_solver->clause_starts);
+	sat_solver->clause_sizes = Free(sat_solver->clause_sizes);
+	sat_solver->watches = Free(sat_solver->watches);
+	sat_solver->num_of_watches = Free(sat_solver->num_of_watches);
+	sat_solver->max_num_of_watches = Free(sat_solver->max_num_of_watches);
+	sat_solver->values = Free(sat_solver->values);
+	sat_solver->phases = Free(sat_solver->phases);
+	sat_solver->model = Free(sat_solver->model);
+	sat_solver->seen = Free(sat_solver->seen);
+	sat_solver->levels = Free(sat_solver->levels);
+	sat_solver->reasons = Free(sat_solver->reasons);
+	sat_solver->trail = Free(sat_solver->trail);
+	sat_solver->trail_limits = Free(sat_solver->trail_limits);
+	sat_solver->learnt = Free(sat_solver->learnt);
+	sat_solver->activities = Free(sat_solver->activities);
+	sat_solver->heap = Free(sat_solver->heap);
+	sat_solver->heap_positions = Free(sat_solver->heap_positions);
+	if (!keep_outer) {
+		sat_solver = Free(sat_solver);
+		return NULL;
+	}
+	sat_solver->activity_increment = 1;
+	sat_solver->num_of_vars = 0;
+	sat_solver->max_num_of_vars = 0;
+	sat_solver->num_of_clauses = 0;
+	sat_solver->max_num_of_clauses = 0;
+	sat_solver->num_of_literals = 0;
+	sat_solver->max_num_of_literals = 0;
+	sat_solver->trail_size = 0;
+	sat_solver->num_of_levels = 0;
+	sat_solver->propagation_head = 0;
+	sat_solver->heap_size = 0;
+	sat_solver->is_unsat = false;
+	return NULL;
+}
+
+assignment_iterator* assignment_iterator_free(assignment_iterator *assignment_iterator, bool keep_outer) {
+	if (assignment_iterator == NULL) {
+		return NULL;
+	}
+	assignment_iterator->digits = Free(assignment_iterator->digits);
+	if (!keep_outer) {
+		assignment_iterator = Free(assignment_iterator);
+		return NULL;
+	}
+	assignment_iterator->gates = NULL;
+	assignment_iterator->other_gate_indices = NULL;
+	assignment_iterator->feasible_gate_types = NULL;
+	assignment_iterator->num_of_feasible_gate_types = NULL;
+	assignment_iterator->num_of_other_gates = 0;
+	assignment_iterator->candidate = 0;
+	assignment_iterator->last_candidate = 0;
+	return NULL;
+}
+
+size_t signal_table_find(signal_table *signal_table, const char *name, size_t length) {
+	size_t num_of_buckets = signal_table->num_of_buckets;
+	if (num_of_buckets == 0) {
+		return SIZE_MAX;
+	}
+	size_t bucket = signal_table_hash(name, length) & (num_of_buckets - 1);
+	while (signal_table->buckets[bucket] != 0) {
+		size_t id = signal_table->buckets[bucket] - 1;
+		if (strncmp(signal_table->names[id], name, length) == 0 && signal_table->names[id][length] == '\0') {
+			return id;
 		}
-		if (curr_gate_index == 0) {
-			break;
+		bucket = (bucket + 1) & (num_of_buckets - 1);
+	}
+	return SIZE_MAX;
+}
+
+void signal_table_insert_bucket(signal_table *signal_table, size_t id) {
+	size_t num_of_buckets = signal_table->num_of_buckets;
+	size_t bucket = signal_table_hash(signal_table->names[id], strlen(signal_table->names[id])) & (num_of_buckets - 1);
+	while (signal_table->buckets[bucket] != 0) {
+		bucket = (bucket + 1) & (num_of_buckets - 1);
+	}
+	signal_table->buckets[bucket] = id + 1;
+}
+
+// Sizes the buckets to the smallest power of two that keeps the table at most half full and inserts
+// every signal again.
+void signal_table_rehash(signal_table *signal_table) {
+	size_t num_of_buckets = 32;
+	while (signal_table->num_of_signals * 2 > num_of_buckets) {
+		num_of_buckets *= 2;
+	}
+	signal_table->buckets = Free(signal_table->buckets);
+	signal_table->buckets = calloc(num_of_buckets, sizeof(size_t));
+	signal_table->num_of_buckets = num_of_buckets;
+	for (size_t i = 0; i < signal_table->num_of_signals; i++) {
+		signal_table_insert_bucket(signal_table, i);
+	}
+}
+
+size_t signal_table_intern(signal_table *signal_table, const char *name, size_t length) {
+	size_t id = signal_table_find(signal_table, name, length);
+	if (id != SIZE_MAX) {
+		return id;
+	}
+	id = signal_table->num_of_signals;
+	if (id == signal_table->max_num_of_signals) {
+		size_t max_num_of_signals = (id == 0) ? 16 : id * 2;
+		signal_table->names = realloc(signal_table->names, sizeof(char*) * max_num_of_signals);
+		signal_table->defined = realloc(signal_table->defined, sizeof(bool) * max_num_of_signals);
+		signal_table->max_num_of_signals = max_num_of_signals;
+	}
+	signal_table->names[id] = malloc(sizeof(char) * (length + 1));
+	memcpy(signal_table->names[id], name, length);
+	signal_table->names[id][length] = '\0';
+	signal_table->defined[id] = false;
+	signal_table->num_of_signals++;
+	if (signal_table->num_of_signals * 2 > signal_table->num_of_buckets) {
+		signal_table_rehash(signal_table);
+	} else {
+		signal_table_insert_bucket(signal_table, id);
+	}
+	return id;
+}
+
+size_t signal_table_define(signal_table *signal_table, const char *name, size_t length) {
+	size_t id = signal_table_intern(signal_table, name, length);
+	signal_table->defined[id] = true;
+	return id;
+}
+
+bool signal_table_is_defined(signal_table *signal_table, const char *name, size_t length) {
+	size_t id = signal_table_find(signal_table, name, length);
+	return id != SIZE_MAX && signal_table->defined[id];
+}
+
+void input_output_intern(input_output *IO, signal_table *signals) {
+	size_t num_of_inputs = IO->num_of_inputs;
+	size_t num_of_outputs = IO->num_of_outputs;
+	size_t num_of_selectors = IO->num_of_selectors;
+	IO->input_ids = malloc(sizeof(size_t) * num_of_inputs);
+	IO->output_ids = malloc(sizeof(size_t) * num_of_outputs);
+	IO->selector_ids = malloc(sizeof(size_t) * num_of_selectors);
+	for (size_t i = 0; i < num_of_inputs; i++) {
+		IO->input_ids[i] = signal_table_intern(signals, IO->inputs[i], strlen(IO->inputs[i]));
+	}
+	for (size_t i = 0; i < num_of_selectors; i++) {
+		IO->selector_ids[i] = signal_table_intern(signals, IO->selectors[i], strlen(IO->selectors[i]));
+	}
+	for (size_t i = 0; i < num_of_outputs; i++) {
+		IO->output_ids[i] = signal_table_define(signals, IO->outputs[i], strlen(IO->outputs[i]));
+	}
+}
+
+size_t get_num_of_assignments(circuit *circuit) {
+	size_t num_of_other_gates = circuit->num_of_other_gates;
+	size_t num_of_assignments = 1;
+	bool is_saturated = false;
+	for (size_t i = 0; i < num_of_other_gates; i++) {
+		size_t num_of_types = circuit->num_of_feasible_gate_types[i];
+		if (num_of_types == 0) {
+			return 0;
+		}
+		if (num_of_assignments > SIZE_MAX / num_of_types) {
+			is_saturated = true;
+		} else {
+			num_of_assignments *= num_of_types;
+		}
+	}
+	if (is_saturated) {
+		return SIZE_MAX;
+	}
+	return num_of_assignments;
+}
+
+// Assignments are numbered in mixed radix over each unknown gate's feasible types, with the last
+// unknown gate as the lowest digit. Seeking decodes the first number of [first_candidate, last_candidate)
+// into the gate types, so a search can be resumed or split into ranges without enumerating what comes before.
+void assignment_iterator_seek(assignment_iterator *assignment_iterator, size_t first_candidate, size_t last_candidate) {
+	size_t candidate = first_candidate;
+	for (size_t z = assignment_iterator->num_of_other_gates; z > 0; z--) {
+		gate *gate = assignment_iterator->gates[assignment_iterator->other_gate_indices[z - 1]];
+		size_t num_of_types = assignment_iterator->num_of_feasible_gate_types[z - 1];
+		assignment_iterator->digits[z - 1] = candidate % num_of_types;
+		gate->type = assignment_iterator->feasible_gate_types[(z - 1) * GATE_COUNT + assignment_iterator->digits[z - 1]];
+		candidate /= num_of_types;
+	}
+	assignment_iterator->candidate = first_candidate;
+	assignment_iterator->last_candidate = last_candidate;
+}
+
+// Steps to the next assignment in order, touching only the gates whose digit changes.
+bool assignment_iterator_next(assignment_iterator *assignment_iterator) {
+	if (assignment_iterator->candidate + 1 >= assignment_iterator->last_candidate) {
+		return false;
+	}
+	assignment_iterator->candidate++;
+	for (size_t z = assignment_iterator->num_of_other_gates; z > 0; z--) {
+		gate *gate = assignment_iterator->gates[assignment_iterator->other_gate_indices[z - 1]];
+		gate_type *feasible_gate_types = assignment_iterator->feasible_gate_types + (z - 1) * GATE_COUNT;
+		assignment_iterator->digits[z - 1]++;
+		if (assignment_iterator->digits[z - 1] < assignment_iterator->num_of_feasible_gate_types[z - 1]) {
+			gate->type = feasible_gate_types[assignment_iterator->digits[z - 1]];
+			return true;
 		}
-		curr_gate_index--;
-		circuit->other_gate_permutations[j] = curr_gate_index;
-		last_index = j;
+		assignment_iterator->digits[z - 1] = 0;
+		gate->type = feasible_gate_types[0];
 	}
+	return true;
 }
 
 size_t binary_to_gray(size_t binary, size_t num_of_bits) {
@@ -1091,636 +1879,3195 @@ outcomes* outcomes_builder(size_t num_of_bits) {
 	return outcomes;
 }
 
-input_value* input_value_builder(char *file) {
-	input_value *input_value = input_value_constructor();
-	FILE *fp = NULL;
-	if ((fp = fopen(file, "r")) == NULL) {
+tokenizer* tokenizer_open(char *file) {
+	int fd = open(file, O_RDONLY);
+	if (fd < 0) {
 		return NULL;
 	}
-	size_t num_of_input_vars = 0;
-	size_t num_of_output_vars = 0;
-	size_t line_counter = 0;
-	readLine_char_firstD *line = NULL;
-	while ((line = readLine(fp, line, 1, " ")) != NULL) {
-		if ((*line).size == 0) {
-			continue;
-		}
-		line_counter++;
-		if (strcmp(line->i[0].j, "INPUTVAR") == 0) {
-			sscanf(line->i[1].j, "%zu", &num_of_input_vars);
-			continue;
-		}
-		if (strcmp(line->i[0].j, "OUTPUTVAR") == 0) {
-			sscanf(line->i[1].j, "%zu", &num_of_output_vars);
-			continue;
-		}
-		if (line_counter <= 3 + num_of_output_vars) {
-			continue;
-		}
-		if (strcmp(line->i[0].j, "OR") == 0) {
-			num_of_input_vars++;
-			continue;
-		}
-		if (strcmp(line->i[0].j, "AND") == 0) {
-			num_of_input_vars++;
-			continue;
-		}
-		if (strcmp(line->i[0].j, "XOR") == 0) {
-			num_of_input_vars++;
-			continue;
+	struct stat file_stat;
+	if (fstat(fd, &file_stat) != 0) {
+		close(fd);
+		return NULL;
+	}
+	tokenizer *tokenizer = tokenizer_constructor();
+	tokenizer->size = (size_t) file_stat.st_size;
+	if (tokenizer->size > 0) {
+		void *data = mmap(NULL, tokenizer->size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data == MAP_FAILED) {
+			close(fd);
+			return tokenizer_free(tokenizer, false);
 		}
-		if (strcmp(line->i[0].j, "NOT") == 0) {
-			num_of_input_vars++;
+		tokenizer->data = data;
+	}
+	close(fd);
+	return tokenizer;
+}
+
+void tokenizer_add_token(tokenizer *tokenizer, const char *start, size_t length) {
+	size_t num_of_tokens = tokenizer->num_of_tokens;
+	if (num_of_tokens == tokenizer->max_num_of_tokens) {
+		size_t max_num_of_tokens = (num_of_tokens == 0) ? 64 : num_of_tokens * 2;
+		tokenizer->tokens = realloc(tokenizer->tokens, sizeof(token) * max_num_of_tokens);
+		tokenizer->max_num_of_tokens = max_num_of_tokens;
+	}
+	tokenizer->tokens[num_of_tokens].start = start;
+	tokenizer->tokens[num_of_tokens].length = length;
+	tokenizer->num_of_tokens++;
+}
+
+bool tokenizer_next_line(tokenizer *tokenizer) {
+	const char *data = tokenizer->data;
+	size_t size = tokenizer->size;
+	size_t position = tokenizer->position;
+	tokenizer->num_of_tokens = 0;
+	if (position >= size) {
+		return false;
+	}
+	const char *newline = memchr(data + position, '\n', size - position);
+	size_t end = (newline == NULL) ? size : (size_t) (newline - data);
+	while (position < end) {
+		if (data[position] == ' ') {
+			position++;
 			continue;
 		}
-		if (strcmp(line->i[0].j, "DECODER") == 0) {
-			size_t ONE = 1;
-			size_t num_of_decoder_inputs = 0;
-			sscanf(line->i[1].j, "%zu", &num_of_decoder_inputs);
-			num_of_input_vars += (ONE << num_of_decoder_inputs);
-			continue;
+		size_t start = position;
+		while (position < end && data[position] != ' ') {
+			position++;
 		}
-		if (strcmp(line->i[0].j, "MULTIPLEXER") == 0) {
-			num_of_input_vars++;
-			continue;
-		}
-		size_t ONE = 1;
-		size_t num_of_other_vars = 0;
-		sscanf(line->i[1].j, "%zu", &num_of_other_vars);
-		num_of_input_vars += (num_of_other_vars - ONE); 
+		tokenizer_add_token(tokenizer, data + start, position - start);
 	}
-	line = readLine_free(line);
-	fclose(fp);
-	fp = NULL;
-	num_of_input_vars += 2;
-	input_value->max_num_of_inputs = num_of_input_vars;
-	input_value->inputs = malloc(sizeof(input*) * num_of_input_vars);
-	for (size_t i = 0; i < num_of_input_vars; i++) {
+	tokenizer->position = end + 1;
+	return true;
+}
+
+bool token_equals(token token, char *string) {
+	return strncmp(token.start, string, token.length) == 0 && string[token.length] == '\0';
+}
+
+size_t token_to_size(token token) {
+	size_t result = 0;
+	for (size_t i = 0; i < token.length && token.start[i] >= '0' && token.start[i] <= '9'; i++) {
+		result = result * 10 + (size_t) (token.start[i] - '0');
+	}
+	return result;
+}
+
+char* token_to_string(token token) {
+	char *string = malloc(sizeof(char) * (token.length + 1));
+	memcpy(string, token.start, token.length);
+	string[token.length] = '\0';
+	return string;
+}
+
+void input_value_allocate_inputs(input_value *input_value, size_t number_input_vars) {
+	input_value->original_num_of_inputs = number_input_vars;
+	input_value->num_of_inputs = number_input_vars + 2;
+	input_value->inputs = malloc(sizeof(input*) * (number_input_vars + 2));
+	for (size_t i = 0; i < number_input_vars + 2; i++) {
 		input_value->inputs[i] = input_constructor();
 	}
-	if ((fp = fopen(file, "r")) == NULL) {
-		return NULL;
+	size_t string_length = 2;
+	input_value->inputs[number_input_vars]->input = malloc(sizeof(char) * string_length);
+	strcpy(input_value->inputs[number_input_vars]->input, "0");
+	input_value->inputs[number_input_vars]->value = 0;
+	input_value->inputs[number_input_vars + 1]->input = malloc(sizeof(char) * string_length);
+	strcpy(input_value->inputs[number_input_vars + 1]->input, "1");
+	input_value->inputs[number_input_vars + 1]->value = 1;
+}
+
+void input_value_add_primary_inputs(input_value *input_value, token *tokens, signal_table *signals) {
+	size_t number_input_vars = token_to_size(tokens[1]);
+	input_value_allocate_inputs(input_value, number_input_vars);
+	for (size_t i = 0; i < number_input_vars; i++) {
+		input_value->inputs[i]->input = token_to_string(tokens[2 + i]);
 	}
-	line = NULL;
-	while ((line = readLine(fp, line, 1, " ")) != NULL) {
-		if ((*line).size == 0) {
-			continue;
-		}
-		if (strcmp(line->i[0].j, "INPUTVAR") == 0) {
-			size_t number_input_vars = 0;
-			sscanf(line->i[1].j, "%zu", &number_input_vars);
-			input_value->original_num_of_inputs = number_input_vars;
-			for (size_t i = 0; i < number_input_vars; i++) {
-				input_value->current_num_of_inputs++;
-				size_t string_length = strlen(line->i[2 + i].j) + 1;
-				input_value->inputs[i]->input = malloc(sizeof(char) * string_length);
-				strcpy(input_value->inputs[i]->input, line->i[2 + i].j);
-			} 
-			input_value->current_num_of_inputs += 2;
-			size_t string_length = 2;
-			input_value->inputs[number_input_vars]->input = malloc(sizeof(char) * string_length);
-			strcpy(input_value->inputs[number_input_vars]->input, "0");
-			input_value->inputs[number_input_vars]->value = 0;
-			input_value->inputs[number_input_vars + 1]->input = malloc(sizeof(char) * string_length);
-			strcpy(input_value->inputs[number_input_vars + 1]->input, "1");
-			input_value->inputs[number_input_vars + 1]->value = 1;
-			break;
-		}
+	for (size_t i = 0; i < number_input_vars + 2; i++) {
+		char *name = input_value->inputs[i]->input;
+		signal_table_define(signals, name, strlen(name));
 	}
-	line = readLine_free(line);
-	fclose(fp);
-	fp = NULL;
-	return input_value;
 }
 
-output_value* output_value_builder(char *file, input_value *input_value) {
-	output_value *output_value = output_value_constructor();
-	FILE *fp = NULL;
-	if ((fp = fopen(file, "r")) == NULL) {
-		return NULL;
+void output_value_allocate_outputs(output_value *output_value, size_t num_of_output_vars) {
+	output_value->num_of_outputs = num_of_output_vars;
+	output_value->outputs = malloc(sizeof(output*) * num_of_output_vars);
+	output_value->gen_outputs = malloc(sizeof(output*) * num_of_output_vars);
+	for (size_t i = 0; i < num_of_output_vars; i++) {
+		output_value->outputs[i] = output_constructor();
+		output_value->gen_outputs[i] = output_constructor();
 	}
+}
+
+void output_value_add_output_vars(output_value *output_value, token *tokens) {
+	size_t num_of_output_vars = token_to_size(tokens[1]);
+	output_value_allocate_outputs(output_value, num_of_output_vars);
+	for (size_t i = 0; i < num_of_output_vars; i++) {
+		output_value->outputs[i]->output = token_to_string(tokens[2 + i]);
+		output_value->gen_outputs[i]->output = token_to_string(tokens[2 + i]);
+	}
+}
+
+void output_value_allocate_values(output_value *output_value, input_value *input_value) {
 	size_t ONE = 1;
 	size_t NUM_OF_VALUES = ONE << (input_value->original_num_of_inputs);
-	size_t num_of_output_vars = 0;
-	size_t line_counter = 0;
-	readLine_char_firstD *line = NULL;
-	while ((line = readLine(fp, line, 1, " ")) != NULL) {
-		if ((*line).size == 0) {
-			continue;
-		}
-		line_counter++;
-		if (strcmp(line->i[0].j, "INPUTVAR") == 0) {
-			continue;
-		}
-		if (strcmp(line->i[0].j, "OUTPUTVAR") == 0) {
-			sscanf(line->i[1].j, "%zu", &num_of_output_vars);
-			output_value->num_of_outputs = num_of_output_vars;
-			output_value->outputs = malloc(sizeof(output*) * num_of_output_vars);
-			output_value->gen_outputs = malloc(sizeof(output*) * num_of_output_vars);
-			for (size_t i = 0; i < num_of_output_vars; i++) {
-				output_value->outputs[i] = output_constructor();
-				output_value->gen_outputs[i] = output_constructor();
-				output_value->outputs[i]->num_of_values = NUM_OF_VALUES;
-				output_value->gen_outputs[i]->num_of_values = NUM_OF_VALUES;
-				output_value->outputs[i]->values = malloc(sizeof(size_t) * NUM_OF_VALUES);
-				output_value->gen_outputs[i]->values = malloc(sizeof(size_t) * NUM_OF_VALUES);
-				for (size_t j = 0; j < NUM_OF_VALUES; j++) {
-					output_value->outputs[i]->values[j] = 0;
-					output_value->gen_outputs[i]->values[j] = 0;
-				}
-			}
-			for (size_t i = 0; i < num_of_output_vars; i++) {
-				size_t string_length = strlen(line->i[2 + i].j) + 1;
-				output_value->outputs[i]->output = malloc(sizeof(char) * string_length);
-				output_value->gen_outputs[i]->output = malloc(sizeof(char) * string_length);
-				strcpy(output_value->outputs[i]->output, line->i[2 + i].j);
-				strcpy(output_value->gen_outputs[i]->output, line->i[2 + i].j);
+	size_t NUM_OF_WORDS = (NUM_OF_VALUES + 63) / 64;
+	size_t NUM_OF_PADDED_WORDS = get_num_of_padded_words(NUM_OF_VALUES);
+	output_value->num_of_block_words = get_num_of_block_words(NUM_OF_VALUES);
+	size_t num_of_output_vars = output_value->num_of_outputs;
+	for (size_t i = 0; i < num_of_output_vars; i++) {
+		output_value->outputs[i]->num_of_values = NUM_OF_VALUES;
+		output_value->gen_outputs[i]->num_of_values = NUM_OF_VALUES;
+		output_value->outputs[i]->num_of_words = NUM_OF_WORDS;
+		output_value->gen_outputs[i]->num_of_words = NUM_OF_WORDS;
+		output_value->outputs[i]->words = calloc(NUM_OF_PADDED_WORDS, sizeof(uint64_t));
+		output_value->gen_outputs[i]->words = calloc(NUM_OF_PADDED_WORDS, sizeof(uint64_t));
+	}
+	output_value->probe_words = calloc(num_of_output_vars, sizeof(uint64_t));
+	output_value->probe_rows = malloc(sizeof(size_t) * MAX_NUM_OF_PROBE_ROWS);
+}
+
+void output_value_add_row(output_value *output_value, token *tokens, size_t index_of_output) {
+	size_t ONE = 1;
+	output *output = output_value->outputs[index_of_output];
+	size_t NUM_OF_VALUES = output->num_of_values;
+	for (size_t i = 0; i < NUM_OF_VALUES; i++) {
+		size_t val = token_to_size(tokens[1 + i]);
+		output->words[i / 64] |= (uint64_t) (val & ONE) << (i % 64);
+	}
+}
+
+size_t circuit_add_gate(circuit *circuit) {
+	size_t gate_index = circuit->num_of_gates;
+	if (gate_index == circuit->max_num_of_gates) {
+		size_t max_num_of_gates = (gate_index == 0) ? 16 : gate_index * 2;
+		circuit->gates = realloc(circuit->gates, sizeof(gate*) * max_num_of_gates);
+		circuit->max_num_of_gates = max_num_of_gates;
+	}
+	circuit->gates[gate_index] = gate_constructor();
+	circuit->num_of_gates++;
+	return gate_index;
+}
+
+size_t get_number_of_selectors(size_t num_of_inputs) {
+	size_t ONE = 1;
+	size_t result = ONE;
+	if (num_of_inputs < 3) {
+		return 0;
+	}
+	while (((ONE << result) + result) < num_of_inputs) {
+		result++;
+	}
+	if (((ONE << result) + result) == num_of_inputs) {
+		return result;
+	}
+	return 0;
+}
+
+bool gate_type_fits_arity(gate_type type, input_output *IO) {
+	size_t ONE = 1;
+	switch (type) {
+		case OR:
+		case AND:
+		case XOR:
+			return IO->num_of_inputs == 2 && IO->num_of_outputs == 1 && IO->num_of_selectors == 0;
+		case NOT:
+			return IO->num_of_inputs == 1 && IO->num_of_outputs == 1 && IO->num_of_selectors == 0;
+		case DECODER:
+			return IO->num_of_inputs >= 1 && IO->num_of_inputs < 64 && IO->num_of_outputs == (ONE << IO->num_of_inputs) && IO->num_of_selectors == 0;
+		case MULTIPLEXER:
+			return IO->num_of_inputs >= 2 && IO->num_of_outputs == 1 && (IO->num_of_selectors != 0 || get_number_of_selectors(IO->num_of_inputs) != 0);
+		default:
+			return false;
+	}
+}
+
+// Keeps, in enum order, only the types whose pin counts an unknown gate can satisfy,
+// so the search never visits an assignment that a gate would reject on arity alone.
+void gen_feasible_gate_types(circuit *circuit) {
+	size_t num_of_other_gates = circuit->num_of_other_gates;
+	circuit->feasible_gate_types = malloc(sizeof(gate_type) * num_of_other_gates * GATE_COUNT);
+	circuit->num_of_feasible_gate_types = malloc(sizeof(size_t) * num_of_other_gates);
+	for (size_t i = 0; i < num_of_other_gates; i++) {
+		input_output *IO = circuit->gates[circuit->other_gate_indices[i]]->input_output;
+		size_t num_of_types = 0;
+		for (gate_type type = OR; type <= MULTIPLEXER; type++) {
+			if (gate_type_fits_arity(type, IO)) {
+				circuit->feasible_gate_types[i * GATE_COUNT + num_of_types] = type;
+				num_of_types++;
 			}
-			continue;
 		}
-		if (line_counter == 3) {
-			continue;
+		circuit->num_of_feasible_gate_types[i] = num_of_types;
+	}
+}
+
+void gen_other_gate_indices(circuit *circuit, size_t num_of_other_gates) {
+	size_t num_of_gates = circuit->num_of_gates;
+	circuit->num_of_other_gates = num_of_other_gates;
+	circuit->other_gate_indices = malloc(sizeof(size_t) * num_of_other_gates);
+	size_t curr_index = 0;
+	for (size_t i = 0; i < num_of_gates; i++) {
+		if (circuit->gates[i]->type == OTHER) {
+			circuit->other_gate_indices[curr_index] = i;
+			circuit->gates[i]->type = OR;
+			curr_index++;
 		}
-		if (line_counter > 3 + num_of_output_vars) {
-			break;
+	}
+	gen_feasible_gate_types(circuit);
+}
+
+// Resolves, for every gate output, which gen_outputs slot it publishes to (or NO_OUTPUT_SLOT for an
+// internal wire), so evaluation never has to look primary outputs up by name. Each output name is looked
+// up in the signal table once, and the gate outputs then read their slot by signal id; an output listed
+// twice publishes to its first slot.
+void gen_output_slots(circuit *circuit, output_value *output_value) {
+	size_t num_of_gates = circuit->num_of_gates;
+	size_t num_of_outputs = output_value->num_of_outputs;
+	size_t num_of_signals = circuit->signals->num_of_signals;
+	size_t *signal_slots = malloc(sizeof(size_t) * (num_of_signals + 1));
+	for (size_t i = 0; i < num_of_signals; i++) {
+		signal_slots[i] = NO_OUTPUT_SLOT;
+	}
+	for (size_t k = 0; k < num_of_outputs; k++) {
+		char *name = output_value->outputs[k]->output;
+		size_t id = signal_table_find(circuit->signals, name, strlen(name));
+		if (id < num_of_signals && signal_slots[id] == NO_OUTPUT_SLOT) {
+			signal_slots[id] = k;
 		}
-		for (size_t i = 0; i < NUM_OF_VALUES; i++) {
-			size_t val = 0;
-			sscanf(line->i[1 + i].j, "%zu", &val);
-			output_value->outputs[line_counter - 4]->values[i] = val;
+	}
+	for (size_t i = 0; i < num_of_gates; i++) {
+		input_output *IO = circuit->gates[i]->input_output;
+		IO->output_slots = malloc(sizeof(size_t) * IO->num_of_outputs);
+		for (size_t j = 0; j < IO->num_of_outputs; j++) {
+			IO->output_slots[j] = signal_slots[IO->output_ids[j]];
 		}
 	}
-	line = readLine_free(line);
-	fclose(fp);
-	fp = NULL;
-	return output_value;
+	signal_slots = Free(signal_slots);
 }
 
-circuit* circuit_builder(char *file, input_value *input_value, output_value *output_value) {
-	circuit *circuit = circuit_constructor();
-	FILE *fp = NULL;
-	if ((fp = fopen(file, "r")) == NULL) {
-		return NULL;
+// Lays the circuit out for evaluation. Each gate is placed one level above the deepest gate driving one
+// of its inputs or selectors, and the gates are stored level by level, in file order within a level, so
+// the netlist file may list gates in any order. Gates on a combinational cycle cannot be levelized and
+// share one final level in file order. Per-gate pin counts, pin ids and output slots are copied into a
+// single block in that order so the evaluator reads them front to back. A primary output keeps its slot
+// only on its last driver in that order: the drivers before it are overwritten within the same pass, so
+// comparing what they wrote would reject candidates on values the circuit never ends with.
+// A gate reading a wire sees the wire's first driver in file order, and one reading a primary input or
+// constant sees its value, whatever later gates write there; a primary output always reads as 0. Every
+// other gate output is given a signal of its own past the first num_of_signals, which no gate reads. A
+// gate reading a wire whose driver is not placed before it (a combinational cycle) reads one more signal
+// that nothing writes, so it sees 0 as in a single pass in file order rather than an earlier evaluation.
+compiled_netlist* compiled_netlist_builder(circuit *circuit, size_t num_of_fixed_signals, size_t num_of_signals) {
+	size_t num_of_gates = circuit->num_of_gates;
+	size_t num_of_pins = 0;
+	size_t *drivers = malloc(sizeof(size_t) * num_of_signals);
+	bool *is_output = calloc(num_of_signals + 1, sizeof(bool));
+	for (size_t i = 0; i < num_of_signals; i++) {
+		drivers[i] = SIZE_MAX;
 	}
-	size_t num_of_output_vars = output_value->num_of_outputs;
-	size_t line_counter = 0;
-	readLine_char_firstD *line = NULL;
-	while ((line = readLine(fp, line, 1, " ")) != NULL) {
-		if ((*line).size == 0) {
-			continue;
+	for (size_t k = 0; k < num_of_gates; k++) {
+		input_output *IO = circuit->gates[k]->input_output;
+		for (size_t i = 0; i < IO->num_of_outputs; i++) {
+			is_output[IO->output_ids[i]] = is_output[IO->output_ids[i]] || IO->output_slots[i] != NO_OUTPUT_SLOT;
 		}
-		line_counter++;
 	}
-	line = readLine_free(line);
-	fclose(fp);
-	fp = NULL;
-	size_t num_of_gates = line_counter - 3 - num_of_output_vars;
-	circuit->num_of_gates = num_of_gates;
-	circuit->gates = malloc(sizeof(gate*) * num_of_gates);
-	for (size_t i = 0; i < num_of_gates; i++) {
-		circuit->gates[i] = gate_constructor();
+	for (size_t k = 0; k < num_of_gates; k++) {
+		input_output *IO = circuit->gates[k]->input_output;
+		for (size_t i = 0; i < IO->num_of_outputs; i++) {
+			size_t id = IO->output_ids[i];
+			if (id >= num_of_fixed_signals && !is_output[id] && drivers[id] == SIZE_MAX) {
+				drivers[id] = k;
+			}
+		}
+		num_of_pins += IO->num_of_inputs + IO->num_of_selectors + IO->num_of_outputs;
 	}
-	if ((fp = fopen(file, "r")) == NULL) {
-		return NULL;
+	size_t *fanout_offsets = calloc(num_of_gates + 1, sizeof(size_t));
+	size_t *num_of_pending = calloc(num_of_gates, sizeof(size_t));
+	for (size_t k = 0; k < num_of_gates; k++) {
+		input_output *IO = circuit->gates[k]->input_output;
+		for (size_t i = 0; i < IO->num_of_inputs + IO->num_of_selectors; i++) {
+			size_t id = (i < IO->num_of_inputs) ? IO->input_ids[i] : IO->selector_ids[i - IO->num_of_inputs];
+			if (drivers[id] != SIZE_MAX) {
+				fanout_offsets[drivers[id] + 1]++;
+				num_of_pending[k]++;
+			}
+		}
 	}
-	char **tmp_input_vars = copy_array_of_strings(input_value->inputs, input_value->current_num_of_inputs, input_value->max_num_of_inputs);
-	size_t tmp_current_num_of_input_vars = input_value->current_num_of_inputs;
-	size_t num_of_other_gates = 0;
-	line_counter = 0;
-	line = NULL;
-	while ((line = readLine(fp, line, 1, " ")) != NULL) {
-		if ((*line).size == 0) {
-			continue;
+	for (size_t k = 0; k < num_of_gates; k++) {
+		fanout_offsets[k + 1] += fanout_offsets[k];
+	}
+	size_t *fanouts = malloc(sizeof(size_t) * (fanout_offsets[num_of_gates] + 1));
+	size_t *fanout_positions = malloc(sizeof(size_t) * (num_of_gates + 1));
+	memcpy(fanout_positions, fanout_offsets, sizeof(size_t) * (num_of_gates + 1));
+	for (size_t k = 0; k < num_of_gates; k++) {
+		input_output *IO = circuit->gates[k]->input_output;
+		for (size_t i = 0; i < IO->num_of_inputs + IO->num_of_selectors; i++) {
+			size_t id = (i < IO->num_of_inputs) ? IO->input_ids[i] : IO->selector_ids[i - IO->num_of_inputs];
+			if (drivers[id] != SIZE_MAX) {
+				fanouts[fanout_positions[drivers[id]]++] = k;
+			}
 		}
-		line_counter++;
-		size_t gate_index = line_counter - 3 - num_of_output_vars - 1;
-		if (line_counter <= 3 + num_of_output_vars) {
-			continue;
+	}
+	size_t *levels = calloc(num_of_gates + 1, sizeof(size_t));
+	size_t *queue = malloc(sizeof(size_t) * (num_of_gates + 1));
+	size_t head = 0;
+	size_t tail = 0;
+	for (size_t k = 0; k < num_of_gates; k++) {
+		if (num_of_pending[k] == 0) {
+			queue[tail++] = k;
 		}
-		if (strcmp(line->i[0].j, "OR") == 0) {
-			circuit->gates[gate_index]->type = OR;
-			circuit->gates[gate_index]->input_output->num_of_inputs = 2;
-			circuit->gates[gate_index]->input_output->num_of_outputs = 1;
-			circuit->gates[gate_index]->input_output->inputs = malloc(sizeof(char*) * 2);
-			circuit->gates[gate_index]->input_output->outputs = malloc(sizeof(char*) * 1);
-			size_t string_length = strlen(line->i[1].j) + 1;
-			circuit->gates[gate_index]->input_output->inputs[0] = malloc(sizeof(char) * string_length);
-			string_length = strlen(line->i[2].j) + 1;
-			circuit->gates[gate_index]->input_output->inputs[1] = malloc(sizeof(char) * string_length);
-			string_length = strlen(line->i[3].j) + 1;
-			circuit->gates[gate_index]->input_output->outputs[0] = malloc(sizeof(char) * string_length);
-			strcpy(circuit->gates[gate_index]->input_output->inputs[0], line->i[1].j);
-			strcpy(circuit->gates[gate_index]->input_output->inputs[1], line->i[2].j);
-			strcpy(circuit->gates[gate_index]->input_output->outputs[0], line->i[3].j);
-			add_string_to_array(line->i[3].j, tmp_input_vars, tmp_current_num_of_input_vars);
-			tmp_current_num_of_input_vars++;
-			continue;
+	}
+	size_t num_of_levels = 0;
+	while (head < tail) {
+		size_t k = queue[head++];
+		if (levels[k] + 1 > num_of_levels) {
+			num_of_levels = levels[k] + 1;
 		}
-		if (strcmp(line->i[0].j, "AND") == 0) {
-			circuit->gates[gate_index]->type = AND;
-			circuit->gates[gate_index]->input_output->num_of_inputs = 2;
-			circuit->gates[gate_index]->input_output->num_of_outputs = 1;
-			circuit->gates[gate_index]->input_output->inputs = malloc(sizeof(char*) * 2);
-			circuit->gates[gate_index]->input_output->outputs = malloc(sizeof(char*) * 1);
-			size_t string_length = strlen(line->i[1].j) + 1;
-			circuit->gates[gate_index]->input_output->inputs[0] = malloc(sizeof(char) * string_length);
-			string_length = strlen(line->i[2].j) + 1;
-			circuit->gates[gate_index]->input_output->inputs[1] = malloc(sizeof(char) * string_length);
-			string_length = strlen(line->i[3].j) + 1;
-			circuit->gates[gate_index]->input_output->outputs[0] = malloc(sizeof(char) * string_length);
-			strcpy(circuit->gates[gate_index]->input_output->inputs[0], line->i[1].j);
-			strcpy(circuit->gates[gate_index]->input_output->inputs[1], line->i[2].j);
-			strcpy(circuit->gates[gate_index]->input_output->outputs[0], line->i[3].j);
-			add_string_to_array(line->i[3].j, tmp_input_vars, tmp_current_num_of_input_vars);
-			tmp_current_num_of_input_vars++;
-			continue;
+		for (size_t i = fanout_offsets[k]; i < fanout_offsets[k + 1]; i++) {
+			size_t fanout = fanouts[i];
+			if (levels[fanout] < levels[k] + 1) {
+				levels[fanout] = levels[k] + 1;
+			}
+			num_of_pending[fanout]--;
+			if (num_of_pending[fanout] == 0) {
+				queue[tail++] = fanout;
+			}
 		}
-		if (strcmp(line->i[0].j, "XOR") == 0) {
-			circuit->gates[gate_index]->type = XOR;
-			circuit->gates[gate_index]->input_output->num_of_inputs = 2;
-			circuit->gates[gate_index]->input_output->num_of_outputs = 1;
-			circuit->gates[gate_index]->input_output->inputs = malloc(sizeof(char*) * 2);
-			circuit->gates[gate_index]->input_output->outputs = malloc(sizeof(char*) * 1);
-			size_t string_length = strlen(line->i[1].j) + 1;
-			circuit->gates[gate_index]->input_output->inputs[0] = malloc(sizeof(char) * string_length);
-			string_length = strlen(line->i[2].j) + 1;
-			circuit->gates[gate_index]->input_output->inputs[1] = malloc(sizeof(char) * string_length);
-			string_length = strlen(line->i[3].j) + 1;
-			circuit->gates[gate_index]->input_output->outputs[0] = malloc(sizeof(char) * string_length);
-			strcpy(circuit->gates[gate_index]->input_output->inputs[0], line->i[1].j);
-			strcpy(circuit->gates[gate_index]->input_output->inputs[1], line->i[2].j);
-			strcpy(circuit->gates[gate_index]->input_output->outputs[0], line->i[3].j);
-			add_string_to_array(line->i[3].j, tmp_input_vars, tmp_current_num_of_input_vars);
-			tmp_current_num_of_input_vars++;
-			continue;
+	}
+	if (tail < num_of_gates) {
+		for (size_t k = 0; k < num_of_gates; k++) {
+			if (num_of_pending[k] > 0) {
+				levels[k] = num_of_levels;
+			}
 		}
-		if (strcmp(line->i[0].j, "NOT") == 0) {
-			circuit->gates[gate_index]->type = NOT;
-			circuit->gates[gate_index]->input_output->num_of_inputs = 1;
-			circuit->gates[gate_index]->input_output->num_of_outputs = 1;
-			circuit->gates[gate_index]->input_output->inputs = malloc(sizeof(char*) * 1);
-			circuit->gates[gate_index]->input_output->outputs = malloc(sizeof(char*) * 1);
-			size_t string_length = strlen(line->i[1].j) + 1;
-			circuit->gates[gate_index]->input_output->inputs[0] = malloc(sizeof(char) * string_length);
-			string_length = strlen(line->i[2].j) + 1;
-			circuit->gates[gate_index]->input_output->outputs[0] = malloc(sizeof(char) * string_length);
-			strcpy(circuit->gates[gate_index]->input_output->inputs[0], line->i[1].j);
-			strcpy(circuit->gates[gate_index]->input_output->outputs[0], line->i[2].j);
-			add_string_to_array(line->i[2].j, tmp_input_vars, tmp_current_num_of_input_vars);
-			tmp_current_num_of_input_vars++;
-			continue;
+		num_of_levels++;
+	}
+	compiled_netlist *compiled_netlist = compiled_netlist_constructor();
+	size_t num_of_words = 7 * num_of_gates + 1 + num_of_levels + 1 + 2 * num_of_pins;
+	size_t *block = malloc(sizeof(size_t) * num_of_words);
+	compiled_netlist->gate_indices = block;
+	compiled_netlist->positions = compiled_netlist->gate_indices + num_of_gates;
+	compiled_netlist->levels = compiled_netlist->positions + num_of_gates;
+	compiled_netlist->level_offsets = compiled_netlist->levels + num_of_gates;
+	compiled_netlist->num_of_inputs = compiled_netlist->level_offsets + num_of_levels + 1;
+	compiled_netlist->num_of_selectors = compiled_netlist->num_of_inputs + num_of_gates;
+	compiled_netlist->num_of_outputs = compiled_netlist->num_of_selectors + num_of_gates;
+	compiled_netlist->pin_offsets = compiled_netlist->num_of_outputs + num_of_gates;
+	compiled_netlist->pins = compiled_netlist->pin_offsets + num_of_gates + 1;
+	compiled_netlist->output_slots = compiled_netlist->pins + num_of_pins;
+	compiled_netlist->num_of_gates = num_of_gates;
+	compiled_netlist->num_of_levels = num_of_levels;
+	compiled_netlist->num_of_pins = num_of_pins;
+	size_t *level_offsets = compiled_netlist->level_offsets;
+	memset(level_offsets, 0, sizeof(size_t) * (num_of_levels + 1));
+	for (size_t k = 0; k < num_of_gates; k++) {
+		level_offsets[levels[k] + 1]++;
+	}
+	for (size_t l = 0; l < num_of_levels; l++) {
+		level_offsets[l + 1] += level_offsets[l];
+	}
+	memcpy(queue, level_offsets, sizeof(size_t) * num_of_levels);
+	for (size_t k = 0; k < num_of_gates; k++) {
+		size_t position = queue[levels[k]]++;
+		compiled_netlist->gate_indices[position] = k;
+		compiled_netlist->positions[k] = position;
+		compiled_netlist->levels[position] = levels[k];
+	}
+	size_t pin_offset = 0;
+	for (size_t position = 0; position < num_of_gates; position++) {
+		input_output *IO = circuit->gates[compiled_netlist->gate_indices[position]]->input_output;
+		size_t *pins = compiled_netlist->pins + pin_offset;
+		size_t *output_slots = compiled_netlist->output_slots + pin_offset;
+		compiled_netlist->num_of_inputs[position] = IO->num_of_inputs;
+		compiled_netlist->num_of_selectors[position] = IO->num_of_selectors;
+		compiled_netlist->num_of_outputs[position] = IO->num_of_outputs;
+		compiled_netlist->pin_offsets[position] = pin_offset;
+		memcpy(pins, IO->input_ids, sizeof(size_t) * IO->num_of_inputs);
+		memcpy(pins + IO->num_of_inputs, IO->selector_ids, sizeof(size_t) * IO->num_of_selectors);
+		memcpy(pins + IO->num_of_inputs + IO->num_of_selectors, IO->output_ids, sizeof(size_t) * IO->num_of_outputs);
+		for (size_t i = 0; i < IO->num_of_inputs + IO->num_of_selectors; i++) {
+			output_slots[i] = NO_OUTPUT_SLOT;
 		}
-		if (strcmp(line->i[0].j, "DECODER") == 0) {
-			circuit->gates[gate_index]->type = DECODER;
-			size_t ONE = 1;
-			size_t num_of_decoder_inputs = 0;
-			sscanf(line->i[1].j, "%zu", &num_of_decoder_inputs);
-			size_t num_of_decoder_outputs = ONE << num_of_decoder_inputs;
-			circuit->gates[gate_index]->input_output->num_of_inputs = num_of_decoder_inputs;
-			circuit->gates[gate_index]->input_output->num_of_outputs = num_of_decoder_outputs;
-			circuit->gates[gate_index]->input_output->inputs = malloc(sizeof(char*) * num_of_decoder_inputs);
-			circuit->gates[gate_index]->input_output->outputs = malloc(sizeof(char*) * num_of_decoder_outputs);
-			size_t string_length = 0;
-			for (size_t i = 0; i < num_of_decoder_inputs; i++) {
-				string_length = strlen(line->i[2 + i].j) + 1;
-				circuit->gates[gate_index]->input_output->inputs[i] = malloc(sizeof(char) * string_length);
-				strcpy(circuit->gates[gate_index]->input_output->inputs[i], line->i[2 + i].j);
+		memcpy(output_slots + IO->num_of_inputs + IO->num_of_selectors, IO->output_slots, sizeof(size_t) * IO->num_of_outputs);
+		pin_offset += IO->num_of_inputs + IO->num_of_selectors + IO->num_of_outputs;
+	}
+	compiled_netlist->pin_offsets[num_of_gates] = pin_offset;
+	bool *is_published = calloc(num_of_signals + 1, sizeof(bool));
+	for (size_t position = num_of_gates; position > 0; position--) {
+		size_t first_output = compiled_netlist->pin_offsets[position] - compiled_netlist->num_of_outputs[position - 1];
+		for (size_t p = first_output; p < compiled_netlist->pin_offsets[position]; p++) {
+			size_t id = compiled_netlist->pins[p];
+			if (compiled_netlist->output_slots[p] != NO_OUTPUT_SLOT && is_published[id]) {
+				compiled_netlist->output_slots[p] = NO_OUTPUT_SLOT;
 			}
-			for (size_t i = 0; i < num_of_decoder_outputs; i++) {
-				string_length = strlen(line->i[2 + num_of_decoder_inputs + i].j) + 1;
-				circuit->gates[gate_index]->input_output->outputs[i] = malloc(sizeof(char) * string_length);
-				strcpy(circuit->gates[gate_index]->input_output->outputs[i], line->i[2 + num_of_decoder_inputs + i].j);
-				add_string_to_array(line->i[2 + num_of_decoder_inputs + i].j, tmp_input_vars, tmp_current_num_of_input_vars);
-				tmp_current_num_of_input_vars++;
+			is_published[id] = is_published[id] || compiled_netlist->output_slots[p] != NO_OUTPUT_SLOT;
+		}
+	}
+	bool *is_claimed = calloc(num_of_signals + 1, sizeof(bool));
+	size_t num_of_compiled_signals = num_of_signals;
+	for (size_t position = 0; position < num_of_gates; position++) {
+		size_t k = compiled_netlist->gate_indices[position];
+		size_t first_output = compiled_netlist->pin_offsets[position + 1] - compiled_netlist->num_of_outputs[position];
+		for (size_t p = first_output; p < compiled_netlist->pin_offsets[position + 1]; p++) {
+			size_t id = compiled_netlist->pins[p];
+			if (drivers[id] == k && !is_claimed[id]) {
+				is_claimed[id] = true;
+			} else {
+				compiled_netlist->pins[p] = num_of_compiled_signals;
+				num_of_compiled_signals++;
 			}
-			continue;
 		}
-		if (strcmp(line->i[0].j, "MULTIPLEXER") == 0) {
-			circuit->gates[gate_index]->type = MULTIPLEXER;
-			size_t num_of_multi_inputs = 0;
-			sscanf(line->i[1].j, "%zu", &num_of_multi_inputs);
-			size_t num_of_multi_selectors = logarithm_base_2_floored(num_of_multi_inputs);
-			circuit->gates[gate_index]->input_output->num_of_inputs = num_of_multi_inputs;
-			circuit->gates[gate_index]->input_output->num_of_outputs = 1;
-			circuit->gates[gate_index]->input_output->num_of_selectors = num_of_multi_selectors;
-			circuit->gates[gate_index]->input_output->inputs = malloc(sizeof(char*) * num_of_multi_inputs);
-			circuit->gates[gate_index]->input_output->outputs = malloc(sizeof(char*) * 1);
-			circuit->gates[gate_index]->input_output->selectors = malloc(sizeof(char*) * num_of_multi_selectors);
-			size_t string_length = 0;
-			for (size_t i = 0; i < num_of_multi_inputs; i++) {
-				string_length = strlen(line->i[2 + i].j) + 1;
-				circuit->gates[gate_index]->input_output->inputs[i] = malloc(sizeof(char) * string_length);
-				strcpy(circuit->gates[gate_index]->input_output->inputs[i], line->i[2 + i].j);
+	}
+	size_t zero_signal = SIZE_MAX;
+	for (size_t position = 0; position < num_of_gates; position++) {
+		size_t first_output = compiled_netlist->pin_offsets[position + 1] - compiled_netlist->num_of_outputs[position];
+		for (size_t p = compiled_netlist->pin_offsets[position]; p < first_output; p++) {
+			size_t driver = drivers[compiled_netlist->pins[p]];
+			if (driver != SIZE_MAX && compiled_netlist->positions[driver] >= position) {
+				if (zero_signal == SIZE_MAX) {
+					zero_signal = num_of_compiled_signals;
+					num_of_compiled_signals++;
+				}
+				compiled_netlist->pins[p] = zero_signal;
 			}
-			for (size_t i = 0; i < num_of_multi_selectors; i++) {
-				string_length = strlen(line->i[2 + num_of_multi_inputs + i].j) + 1;
-				circuit->gates[gate_index]->input_output->selectors[i] = malloc(sizeof(char) * string_length);
-				strcpy(circuit->gates[gate_index]->input_output->selectors[i], line->i[2 + num_of_multi_inputs + i].j);
+		}
+	}
+	compiled_netlist->num_of_signals = num_of_compiled_signals;
+	is_claimed = Free(is_claimed);
+	is_published = Free(is_published);
+	is_output = Free(is_output);
+	drivers = Free(drivers);
+	fanout_offsets = Free(fanout_offsets);
+	num_of_pending = Free(num_of_pending);
+	fanouts = Free(fanouts);
+	fanout_positions = Free(fanout_positions);
+	levels = Free(levels);
+	queue = Free(queue);
+	return compiled_netlist;
+}
+
+compiled_gate get_compiled_gate(compiled_netlist *compiled_netlist, size_t position) {
+	compiled_gate compiled_gate;
+	size_t pin_offset = compiled_netlist->pin_offsets[position];
+	compiled_gate.num_of_inputs = compiled_netlist->num_of_inputs[position];
+	compiled_gate.num_of_selectors = compiled_netlist->num_of_selectors[position];
+	compiled_gate.num_of_outputs = compiled_netlist->num_of_outputs[position];
+	compiled_gate.input_ids = compiled_netlist->pins + pin_offset;
+	compiled_gate.selector_ids = compiled_gate.input_ids + compiled_gate.num_of_inputs;
+	compiled_gate.output_ids = compiled_gate.selector_ids + compiled_gate.num_of_selectors;
+	compiled_gate.output_slots = compiled_netlist->output_slots + pin_offset + compiled_gate.num_of_inputs + compiled_gate.num_of_selectors;
+	return compiled_gate;
+}
+
+size_t get_multiplexer_select_bits(input_output *IO) {
+	if (IO->num_of_selectors != 0) {
+		return IO->num_of_selectors;
+	}
+	return get_number_of_selectors(IO->num_of_inputs);
+}
+
+size_t get_multiplexer_selector_offset(input_output *IO) {
+	if (IO->num_of_selectors != 0) {
+		return IO->num_of_inputs;
+	}
+	return IO->num_of_inputs - get_number_of_selectors(IO->num_of_inputs);
+}
+
+// The arity checks the evaluator used to repeat on every pattern are made here, once per gate and type:
+// a type that does not fit the gate's pins compiles to OP_FAIL.
+size_t bytecode_opcode(gate_type type, input_output *IO) {
+	size_t ONE = 1;
+	if (!gate_type_fits_arity(type, IO)) {
+		return OP_FAIL;
+	}
+	switch (type) {
+		case OR:
+			return OP_OR;
+		case AND:
+			return OP_AND;
+		case XOR:
+			return OP_XOR;
+		case NOT:
+			return OP_NOT;
+		case DECODER:
+			return OP_DECODER;
+		case MULTIPLEXER:
+			if (get_multiplexer_select_bits(IO) >= MAX_NUM_OF_SELECT_BITS || (ONE << get_multiplexer_select_bits(IO)) > get_multiplexer_selector_offset(IO)) {
+				return OP_FAIL;
+			}
+			return OP_MULTIPLEXER;
+		default:
+			return OP_FAIL;
+	}
+}
+
+// Compiles the levelized netlist into one flat program. Each instruction is laid out as
+// [opcode, inputs, selectors, outputs, select bits, selector offset, pin ids..., output slots...], so an
+// unknown gate keeps the same operands whatever type it is given and only its opcode word is rewritten;
+// the opcode of every unknown gate for every type is precomputed in other_gate_opcodes.
+bytecode* bytecode_builder(circuit *circuit) {
+	compiled_netlist *compiled_netlist = circuit->compiled_netlist;
+	size_t num_of_gates = compiled_netlist->num_of_gates;
+	size_t num_of_other_gates = circuit->num_of_other_gates;
+	size_t num_of_words = 0;
+	for (size_t k = 0; k < num_of_gates; k++) {
+		num_of_words += BYTECODE_HEADER_WORDS + compiled_netlist->num_of_inputs[k] + compiled_netlist->num_of_selectors[k] + 2 * compiled_netlist->num_of_outputs[k];
+	}
+	bytecode *bytecode = bytecode_constructor();
+	bytecode->code = malloc(sizeof(size_t) * (num_of_words + 1));
+	bytecode->instruction_offsets = malloc(sizeof(size_t) * (num_of_gates + 1));
+	bytecode->other_gate_offsets = malloc(sizeof(size_t) * (num_of_other_gates + 1));
+	bytecode->other_gate_opcodes = malloc(sizeof(size_t) * (num_of_other_gates * GATE_COUNT + 1));
+	bytecode->other_gate_indices = circuit->other_gate_indices;
+	bytecode->compiled_netlist = compiled_netlist;
+	bytecode->num_of_words = num_of_words;
+	bytecode->num_of_gates = num_of_gates;
+	bytecode->num_of_other_gates = num_of_other_gates;
+	size_t offset = 0;
+	for (size_t k = 0; k < num_of_gates; k++) {
+		gate *gate = circuit->gates[compiled_netlist->gate_indices[k]];
+		input_output *IO = gate->input_output;
+		size_t num_of_pins = IO->num_of_inputs + IO->num_of_selectors + IO->num_of_outputs;
+		size_t pin_offset = compiled_netlist->pin_offsets[k];
+		size_t *instruction = bytecode->code + offset;
+		bytecode->instruction_offsets[k] = offset;
+		instruction[0] = bytecode_opcode(gate->type, IO);
+		instruction[1] = IO->num_of_inputs;
+		instruction[2] = IO->num_of_selectors;
+		instruction[3] = IO->num_of_outputs;
+		instruction[4] = get_multiplexer_select_bits(IO);
+		instruction[5] = get_multiplexer_selector_offset(IO);
+		memcpy(instruction + BYTECODE_HEADER_WORDS, compiled_netlist->pins + pin_offset, sizeof(size_t) * num_of_pins);
+		memcpy(instruction + BYTECODE_HEADER_WORDS + num_of_pins, compiled_netlist->output_slots + pin_offset + num_of_pins - IO->num_of_outputs, sizeof(size_t) * IO->num_of_outputs);
+		offset += BYTECODE_HEADER_WORDS + num_of_pins + IO->num_of_outputs;
+	}
+	bytecode->instruction_offsets[num_of_gates] = offset;
+	for (size_t z = 0; z < num_of_other_gates; z++) {
+		size_t index_of_gate = circuit->other_gate_indices[z];
+		input_output *IO = circuit->gates[index_of_gate]->input_output;
+		bytecode->other_gate_offsets[z] = bytecode->instruction_offsets[compiled_netlist->positions[index_of_gate]];
+		for (size_t t = 0; t < GATE_COUNT; t++) {
+			bytecode->other_gate_opcodes[z * GATE_COUNT + t] = bytecode_opcode((gate_type) (OR + t), IO);
+		}
+	}
+	return bytecode;
+}
+
+// Each search worker runs its own copy of the program because the opcodes of the unknown gates follow
+// that worker's assignment; the offset and opcode tables are shared with the source.
+bytecode* bytecode_clone(bytecode *source) {
+	bytecode *bytecode = bytecode_constructor();
+	bytecode->code = malloc(sizeof(size_t) * (source->num_of_words + 1));
+	memcpy(bytecode->code, source->code, sizeof(size_t) * source->num_of_words);
+	bytecode->instruction_offsets = source->instruction_offsets;
+	bytecode->other_gate_offsets = source->other_gate_offsets;
+	bytecode->other_gate_opcodes = source->other_gate_opcodes;
+	bytecode->other_gate_indices = source->other_gate_indices;
+	bytecode->compiled_netlist = source->compiled_netlist;
+	bytecode->jit_program = source->jit_program;
+	bytecode->num_of_words = source->num_of_words;
+	bytecode->num_of_gates = source->num_of_gates;
+	bytecode->num_of_other_gates = source->num_of_other_gates;
+	return bytecode;
+}
+
+void bytecode_load_types(bytecode *bytecode, gate **gates) {
+	size_t num_of_other_gates = bytecode->num_of_other_gates;
+	for (size_t z = 0; z < num_of_other_gates; z++) {
+		gate_type type = gates[bytecode->other_gate_indices[z]]->type;
+		bytecode->code[bytecode->other_gate_offsets[z]] = bytecode->other_gate_opcodes[z * GATE_COUNT + (type - OR)];
+	}
+}
+
+void jit_source_append(jit_source *jit_source, const char *format, ...) {
+	va_list arguments;
+	va_start(arguments, format);
+	size_t length = vsnprintf(NULL, 0, format, arguments);
+	va_end(arguments);
+	if (jit_source->length + length + 1 > jit_source->max_length) {
+		jit_source->max_length = 2 * (jit_source->length + length + 1);
+		jit_source->text = realloc(jit_source->text, sizeof(char) * jit_source->max_length);
+	}
+	va_start(arguments, format);
+	vsnprintf(jit_source->text + jit_source->length, length + 1, format, arguments);
+	va_end(arguments);
+	jit_source->length += length;
+}
+
+// Writes the statements one instruction executes for one word: every plane operation of the interpreter
+// becomes a single expression over the locals that hold the current word of each signal.
+void jit_source_add_operation(jit_source *jit_source, const size_t *instruction, size_t opcode, const char *indent) {
+	size_t ONE = 1;
+	const size_t *pins = instruction + BYTECODE_HEADER_WORDS;
+	const size_t *output_ids = pins + instruction[1] + instruction[2];
+	outcomes *outcomes = NULL;
+	size_t num_of_bits = 0;
+	switch (opcode) {
+		case OP_OR:
+			jit_source_append(jit_source, "%sv%zu = v%zu | v%zu;\n", indent, output_ids[0], pins[0], pins[1]);
+			break;
+		case OP_AND:
+			jit_source_append(jit_source, "%sv%zu = v%zu & v%zu;\n", indent, output_ids[0], pins[0], pins[1]);
+			break;
+		case OP_XOR:
+			jit_source_append(jit_source, "%sv%zu = v%zu ^ v%zu;\n", indent, output_ids[0], pins[0], pins[1]);
+			break;
+		case OP_NOT:
+			jit_source_append(jit_source, "%sv%zu = ~v%zu;\n", indent, output_ids[0], pins[0]);
+			break;
+		case OP_DECODER:
+			num_of_bits = instruction[1];
+			outcomes = outcomes_builder(num_of_bits);
+			for (size_t i = 0; i < outcomes->num_of_outcomes; i++) {
+				jit_source_append(jit_source, "%sv%zu = ", indent, output_ids[i]);
+				for (size_t j = 0; j < num_of_bits; j++) {
+					size_t bit = (outcomes->outcomes[i] >> (num_of_bits - ONE - j)) & ONE;
+					jit_source_append(jit_source, "%s%sv%zu", (j == 0) ? "" : " & ", (bit == 1) ? "" : "~", pins[j]);
+				}
+				jit_source_append(jit_source, ";\n");
+			}
+			outcomes = outcomes_free(outcomes, false);
+			break;
+		case OP_MULTIPLEXER:
+			num_of_bits = instruction[4];
+			outcomes = outcomes_builder(num_of_bits);
+			jit_source_append(jit_source, "%sv%zu = ", indent, output_ids[0]);
+			for (size_t i = 0; i < outcomes->num_of_outcomes; i++) {
+				jit_source_append(jit_source, "%s(v%zu", (i == 0) ? "" : " | ", pins[i]);
+				for (size_t j = 0; j < num_of_bits; j++) {
+					size_t bit = (outcomes->outcomes[i] >> (num_of_bits - ONE - j)) & ONE;
+					jit_source_append(jit_source, " & %sv%zu", (bit == 1) ? "" : "~", pins[instruction[5] + j]);
+				}
+				jit_source_append(jit_source, ")");
 			}
-			string_length = strlen(line->i[2 + num_of_multi_inputs + num_of_multi_selectors].j) + 1;
-			circuit->gates[gate_index]->input_output->outputs[0] = malloc(sizeof(char) * string_length);
-			strcpy(circuit->gates[gate_index]->input_output->outputs[0], line->i[2 + num_of_multi_inputs + num_of_multi_selectors].j);
-			add_string_to_array(line->i[2 + num_of_multi_inputs + num_of_multi_selectors].j, tmp_input_vars, tmp_current_num_of_input_vars);
-			tmp_current_num_of_input_vars++;
+			jit_source_append(jit_source, ";\n");
+			outcomes = outcomes_free(outcomes, false);
+			break;
+		default:
+			break;
+	}
+}
+
+// Translates the program into one C function that runs a whole block word by word, keeping every signal
+// in a local. Each unknown gate becomes a switch on its opcode word, so a single build serves every
+// assignment of the search. Final outputs are published in program order once the words are computed,
+// which is the order in which the interpreter would have published them. The compiled netlist already
+// maps a read of a wire driven at or after its reader, as on a combinational cycle, to a signal no gate
+// drives, so every read is either a plane loaded once per word or a local set by an earlier gate.
+jit_source* jit_source_builder(bytecode *bytecode, size_t num_of_signals) {
+	size_t num_of_gates = bytecode->num_of_gates;
+	size_t num_of_other_gates = bytecode->num_of_other_gates;
+	size_t *last_drivers = malloc(sizeof(size_t) * (num_of_signals + 1));
+	size_t *other_gates = malloc(sizeof(size_t) * (num_of_gates + 1));
+	bool *is_declared = calloc(num_of_signals + 1, sizeof(bool));
+	bool *is_stored = calloc(num_of_signals + 1, sizeof(bool));
+	for (size_t i = 0; i < num_of_signals; i++) {
+		last_drivers[i] = SIZE_MAX;
+	}
+	for (size_t k = 0; k < num_of_gates; k++) {
+		other_gates[k] = SIZE_MAX;
+	}
+	for (size_t z = 0; z < num_of_other_gates; z++) {
+		other_gates[bytecode->compiled_netlist->positions[bytecode->other_gate_indices[z]]] = z;
+	}
+	for (size_t k = 0; k < num_of_gates; k++) {
+		const size_t *instruction = bytecode->code + bytecode->instruction_offsets[k];
+		const size_t *output_ids = instruction + BYTECODE_HEADER_WORDS + instruction[1] + instruction[2];
+		for (size_t i = 0; i < instruction[3]; i++) {
+			last_drivers[output_ids[i]] = k;
+		}
+	}
+	jit_source *jit_source = jit_source_constructor();
+	jit_source_append(jit_source, "#include <stddef.h>\n#include <stdint.h>\n\n");
+	jit_source_append(jit_source, "int circuit_block(uint64_t *s, size_t stride, size_t num_of_words, const size_t *code, int (*publish)(void *, size_t, const uint64_t *), void *context) {\n");
+	for (size_t z = 0; z < num_of_other_gates; z++) {
+		jit_source_append(jit_source, "\tconst size_t op%zu = code[%zu];\n", z, bytecode->other_gate_offsets[z]);
+	}
+	jit_source_append(jit_source, "\tfor (size_t w = 0; w < num_of_words; w++) {\n");
+	for (size_t k = 0; k < num_of_gates; k++) {
+		const size_t *instruction = bytecode->code + bytecode->instruction_offsets[k];
+		for (size_t i = 0; i < instruction[1] + instruction[2]; i++) {
+			size_t id = instruction[BYTECODE_HEADER_WORDS + i];
+			if (!is_declared[id] && last_drivers[id] == SIZE_MAX) {
+				jit_source_append(jit_source, "\t\tconst uint64_t v%zu = s[%zu * stride + w];\n", id, id);
+				is_declared[id] = true;
+			}
+		}
+	}
+	for (size_t id = 0; id < num_of_signals; id++) {
+		if (last_drivers[id] != SIZE_MAX) {
+			jit_source_append(jit_source, "\t\tuint64_t v%zu = 0;\n", id);
+		}
+	}
+	for (size_t k = 0; k < num_of_gates; k++) {
+		const size_t *instruction = bytecode->code + bytecode->instruction_offsets[k];
+		size_t z = other_gates[k];
+		if (z == SIZE_MAX) {
+			jit_source_add_operation(jit_source, instruction, instruction[0], "\t\t");
 			continue;
 		}
-		num_of_other_gates++;
-		circuit->gates[gate_index]->type = OTHER;
-		size_t string_length = 0;
-		size_t num_of_total_vars = 0;
-		sscanf(line->i[1].j, "%zu", &num_of_total_vars);
-		size_t num_of_other_inputs = 0;
-		size_t num_of_other_outputs = 0;
-		for (size_t i = 0; i < num_of_total_vars; i++) {
-			if (array_contains_string(line->i[2 + i].j, tmp_input_vars, tmp_current_num_of_input_vars)) {
-				num_of_other_inputs++;
-			} else {
-				num_of_other_outputs++;
+		jit_source_append(jit_source, "\t\tswitch (op%zu) {\n", z);
+		for (size_t opcode = OP_OR; opcode <= OP_MULTIPLEXER; opcode++) {
+			bool is_feasible = false;
+			for (size_t t = 0; t < GATE_COUNT; t++) {
+				is_feasible = is_feasible || bytecode->other_gate_opcodes[z * GATE_COUNT + t] == opcode;
+			}
+			if (is_feasible) {
+				jit_source_append(jit_source, "\t\t\tcase %zu:\n", opcode);
+				jit_source_add_operation(jit_source, instruction, opcode, "\t\t\t\t");
+				jit_source_append(jit_source, "\t\t\t\tbreak;\n");
 			}
 		}
-		circuit->gates[gate_index]->input_output->num_of_inputs = num_of_other_inputs;
-		circuit->gates[gate_index]->input_output->num_of_outputs = num_of_other_outputs;
-		circuit->gates[gate_index]->input_output->inputs = malloc(sizeof(char*) * num_of_other_inputs);
-		circuit->gates[gate_index]->input_output->outputs = malloc(sizeof(char*) * num_of_other_outputs);
-		size_t input_counter = 0;
-		size_t output_counter = 0;
-		for (size_t i = 0; i < num_of_total_vars; i++) {
-			string_length = strlen(line->i[2 + i].j) + 1;
-			if (array_contains_string(line->i[2 + i].j, tmp_input_vars, tmp_current_num_of_input_vars)) {
-				circuit->gates[gate_index]->input_output->inputs[input_counter] = malloc(sizeof(char) * string_length);
-				strcpy(circuit->gates[gate_index]->input_output->inputs[input_counter], line->i[2 + i].j);
-				input_counter++;
-			} else {
-				circuit->gates[gate_index]->input_output->outputs[output_counter] = malloc(sizeof(char) * string_length);
-				strcpy(circuit->gates[gate_index]->input_output->outputs[output_counter], line->i[2 + i].j);
-				output_counter++;
-				add_string_to_array(line->i[2 + i].j, tmp_input_vars, tmp_current_num_of_input_vars);
-				tmp_current_num_of_input_vars++;
+		jit_source_append(jit_source, "\t\t\tdefault:\n\t\t\t\tbreak;\n\t\t}\n");
+	}
+	for (size_t k = 0; k < num_of_gates; k++) {
+		const size_t *instruction = bytecode->code + bytecode->instruction_offsets[k];
+		const size_t *output_ids = instruction + BYTECODE_HEADER_WORDS + instruction[1] + instruction[2];
+		const size_t *output_slots = output_ids + instruction[3];
+		for (size_t i = 0; i < instruction[3]; i++) {
+			if (output_slots[i] != NO_OUTPUT_SLOT && !is_stored[output_ids[i]]) {
+				jit_source_append(jit_source, "\t\ts[%zu * stride + w] = v%zu;\n", output_ids[i], output_ids[i]);
+				is_stored[output_ids[i]] = true;
 			}
 		}
 	}
-	line = readLine_free(line);
+	jit_source_append(jit_source, "\t}\n");
+	for (size_t k = 0; k < num_of_gates; k++) {
+		const size_t *instruction = bytecode->code + bytecode->instruction_offsets[k];
+		const size_t *output_ids = instruction + BYTECODE_HEADER_WORDS + instruction[1] + instruction[2];
+		const size_t *output_slots = output_ids + instruction[3];
+		if (other_gates[k] != SIZE_MAX) {
+			jit_source_append(jit_source, "\tif (op%zu == %d) {\n\t\treturn 0;\n\t}\n", other_gates[k], OP_FAIL);
+		} else if (instruction[0] == OP_FAIL) {
+			jit_source_append(jit_source, "\treturn 0;\n");
+			break;
+		}
+		for (size_t i = 0; i < instruction[3]; i++) {
+			if (output_slots[i] != NO_OUTPUT_SLOT) {
+				jit_source_append(jit_source, "\tif (!publish(context, %zu, s + %zu * stride)) {\n\t\treturn 0;\n\t}\n", output_slots[i], output_ids[i]);
+			}
+		}
+	}
+	jit_source_append(jit_source, "\treturn 1;\n}\n");
+	last_drivers = Free(last_drivers);
+	other_gates = Free(other_gates);
+	is_declared = Free(is_declared);
+	is_stored = Free(is_stored);
+	return jit_source;
+}
+
+bool jit_source_write(jit_source *jit_source, char *file) {
+	FILE *fp = fopen(file, "w");
+	if (fp == NULL) {
+		return false;
+	}
+	bool is_written = fwrite(jit_source->text, sizeof(char), jit_source->length, fp) == jit_source->length;
+	return fclose(fp) == 0 && is_written;
+}
+
+// Compares the source an object was cached with against the program being loaded, byte for byte, since
+// the cache key is only a 64-bit hash of the source.
+bool jit_source_matches(jit_source *jit_source, char *file) {
+	FILE *fp = fopen(file, "r");
+	if (fp == NULL) {
+		return false;
+	}
+	char *text = malloc(sizeof(char) * (jit_source->length + 1));
+	bool is_match = fread(text, sizeof(char), jit_source->length + 1, fp) == jit_source->length && memcmp(text, jit_source->text, jit_source->length) == 0;
 	fclose(fp);
-	fp = NULL;
-	tmp_input_vars = free_array_of_strings(tmp_input_vars, tmp_current_num_of_input_vars);
-	circuit->num_of_other_gates = num_of_other_gates;
-	circuit->other_gate_indices = malloc(sizeof(size_t) * num_of_other_gates);
-	size_t curr_index = 0;
+	text = Free(text);
+	return is_match;
+}
+
+// A path is trusted to hold native code only when it belongs to the current user and nobody else can
+// write to it; objects must also be regular files rather than links.
+bool jit_path_is_private(const char *path, bool is_directory) {
+	struct stat status;
+	if ((is_directory ? stat(path, &status) : lstat(path, &status)) != 0) {
+		return false;
+	}
+	if (is_directory ? !S_ISDIR(status.st_mode) : !S_ISREG(status.st_mode)) {
+		return false;
+	}
+	return status.st_uid == geteuid() && (status.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+}
+
+char* jit_path(const char *directory, const char *name) {
+	size_t path_length = strlen(directory) + strlen(name) + 2;
+	char *path = malloc(sizeof(char) * path_length);
+	snprintf(path, path_length, "%s/%s", directory, name);
+	return path;
+}
+
+// Returns the directory compiled objects are cached in: $CIRCUIT_JIT_DIR when set, otherwise a
+// circuit-simulator directory under $XDG_CACHE_HOME or ~/.cache. Missing directories are created with mode
+// 0700, and NULL is returned unless the result is private to the current user.
+char* jit_cache_directory(void) {
+	const char *directory = getenv("CIRCUIT_JIT_DIR");
+	char *cache_directory = NULL;
+	if (directory != NULL && directory[0] != '\0') {
+		cache_directory = malloc(sizeof(char) * (strlen(directory) + 1));
+		strcpy(cache_directory, directory);
+	} else {
+		const char *base = getenv("XDG_CACHE_HOME");
+		const char *home = getenv("HOME");
+		char *base_directory = NULL;
+		if (base != NULL && base[0] == '/') {
+			base_directory = malloc(sizeof(char) * (strlen(base) + 1));
+			strcpy(base_directory, base);
+		} else if (home != NULL && home[0] == '/') {
+			base_directory = jit_path(home, ".cache");
+		} else {
+			return NULL;
+		}
+		mkdir(base_directory, 0700);
+		cache_directory = jit_path(base_directory, JIT_CACHE_DIRECTORY);
+		base_directory = Free(base_directory);
+	}
+	mkdir(cache_directory, 0700);
+	if (!jit_path_is_private(cache_directory, true)) {
+		cache_directory = Free(cache_directory);
+		return NULL;
+	}
+	return cache_directory;
+}
+
+// Runs the compiler directly from an argument vector, so neither it nor the paths go through a shell.
+bool jit_compile(const char *compiler, char *library_file, char *source_file) {
+	char *arguments[] = {(char*) compiler, "-O2", "-shared", "-fPIC", "-o", library_file, source_file, NULL};
+	pid_t pid = 0;
+	int status = 0;
+	if (posix_spawnp(&pid, compiler, NULL, NULL, arguments, environ) != 0) {
+		return false;
+	}
+	while (waitpid(pid, &status, 0) < 0) {
+		if (errno != EINTR) {
+			return false;
+		}
+	}
+	return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// Builds the program into a shared object named after the hash of its source and loads it. The object is
+// kept in the directory from jit_cache_directory next to the source it was built from, so a later run over
+// the same netlist skips the compiler; a cached object is only loaded when both files are private to the
+// current user and the source is the one just generated, so two netlists whose sources share a hash
+// never run each other's code. The compiler is $CC (default cc), run as a single program. Returns NULL when no private cache directory is available or the
+// build fails, and the caller keeps interpreting.
+jit_program* jit_program_builder(circuit *circuit) {
+	jit_source *jit_source = jit_source_builder(circuit->bytecode, circuit->compiled_netlist->num_of_signals);
+	const char *compiler = getenv("CC");
+	if (compiler == NULL || compiler[0] == '\0') {
+		compiler = JIT_DEFAULT_COMPILER;
+	}
+	char *directory = jit_cache_directory();
+	if (directory == NULL) {
+		jit_source = jit_source_free(jit_source, false);
+		return NULL;
+	}
+	jit_program *jit_program = jit_program_constructor();
+	jit_program->hash = signal_table_hash(jit_source->text, jit_source->length);
+	char name[64];
+	snprintf(name, sizeof(name), "circuit-%016zx.so", jit_program->hash);
+	char *library = jit_path(directory, name);
+	snprintf(name, sizeof(name), "circuit-%016zx.c", jit_program->hash);
+	char *source = jit_path(directory, name);
+	if (jit_path_is_private(library, false) && jit_path_is_private(source, false) && jit_source_matches(jit_source, source)) {
+		jit_program->handle = dlopen(library, RTLD_NOW | RTLD_LOCAL);
+	}
+	if (jit_program->handle == NULL) {
+		// the object is built and loaded in a fresh private directory, so nobody can swap the intermediate
+		// files, and only then renamed into place, object first, so a concurrent run never pairs a new
+		// source with an old object
+		char *build_directory = jit_path(directory, "build-XXXXXX");
+		if (mkdtemp(build_directory) != NULL) {
+			char *source_file = jit_path(build_directory, "circuit.c");
+			char *library_file = jit_path(build_directory, "circuit.so");
+			if (jit_source_write(jit_source, source_file) && jit_compile(compiler, library_file, source_file)) {
+				jit_program->handle = dlopen(library_file, RTLD_NOW | RTLD_LOCAL);
+			}
+			if (jit_program->handle != NULL && rename(library_file, library) == 0) {
+				rename(source_file, source);
+			}
+			remove(source_file);
+			remove(library_file);
+			rmdir(build_directory);
+			source_file = Free(source_file);
+			library_file = Free(library_file);
+		}
+		build_directory = Free(build_directory);
+	}
+	if (jit_program->handle != NULL) {
+		jit_program->function = (jit_block_function) dlsym(jit_program->handle, "circuit_block");
+	}
+	library = Free(library);
+	source = Free(source);
+	directory = Free(directory);
+	jit_source = jit_source_free(jit_source, false);
+	if (jit_program->function == NULL) {
+		jit_program = jit_program_free(jit_program, false);
+		return NULL;
+	}
+	return jit_program;
+}
+
+// Compiles the netlist to native code; the search workers pick the program up when they clone the
+// bytecode, so this has to run before the search starts. Returns false when the interpreter stays in use.
+bool circuit_enable_jit(circuit *circuit) {
+	circuit->jit_program = jit_program_builder(circuit);
+	circuit->bytecode->jit_program = circuit->jit_program;
+	return circuit->jit_program != NULL;
+}
+
+bool netlist_image_strings_are_valid(const uint32_t *offsets, const char *bytes, size_t num_of_strings, size_t strings_size) {
+	if (offsets[0] != 0) {
+		return false;
+	}
+	for (size_t i = 0; i < num_of_strings; i++) {
+		if (offsets[i + 1] <= offsets[i] || offsets[i + 1] > strings_size || bytes[offsets[i + 1] - 1] != '\0') {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Each pin count is bounded by num_of_pins before the three are added, so the sum cannot wrap around.
+bool netlist_image_gates_are_valid(const uint32_t *gate_types, const uint32_t *gate_pin_counts, const uint32_t *gate_pin_offsets, const uint32_t *gate_pins, size_t num_of_gates, size_t num_of_pins, size_t num_of_signals) {
+	for (size_t i = 0; i < num_of_gates; i++) {
+		if (gate_types[i] < OR || gate_types[i] > OTHER) {
+			return false;
+		}
+		size_t num_of_gate_pins = 0;
+		for (size_t j = 0; j < 3; j++) {
+			if (gate_pin_counts[i * 3 + j] > num_of_pins - num_of_gate_pins) {
+				return false;
+			}
+			num_of_gate_pins += gate_pin_counts[i * 3 + j];
+		}
+		if (gate_pin_offsets[i] > num_of_pins || num_of_gate_pins > num_of_pins - gate_pin_offsets[i]) {
+			return false;
+		}
+		for (size_t j = 0; j < num_of_gate_pins; j++) {
+			if (gate_pins[gate_pin_offsets[i] + j] >= num_of_signals) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool netlist_image_has_magic(const char *data, size_t size) {
+	return size >= sizeof(NETLIST_IMAGE_MAGIC) && memcmp(data, NETLIST_IMAGE_MAGIC, sizeof(NETLIST_IMAGE_MAGIC)) == 0;
+}
+
+// Sections are padded to a multiple of 8 bytes, so every section starts aligned for its element type.
+const void* netlist_image_section(const char *data, size_t size, size_t *position, size_t num_of_elements, size_t element_size) {
+	if (*position > size || num_of_elements > (size - *position) / element_size) {
+		*position = SIZE_MAX;
+		return NULL;
+	}
+	const void *section = data + *position;
+	*position += (num_of_elements * element_size + 7) / 8 * 8;
+	return section;
+}
+
+char* netlist_image_string(const uint32_t *offsets, const char *strings, size_t index) {
+	const char *start = strings + offsets[index];
+	size_t length = offsets[index + 1] - offsets[index] - 1;
+	char *string = malloc(sizeof(char) * (length + 1));
+	memcpy(string, start, length + 1);
+	return string;
+}
+
+// Validates every section of the mapped image and rebuilds the netlist from it without tokenizing any
+// text: ids and counts are read straight from the sections, while names are copied out, so the file can
+// be unmapped as soon as this returns. The signal table buckets, the compiled netlist and the bytecode
+// are derived again on load, and every pin still gets its own copy of its name, so tokenizing is the
+// only work an image saves over the text format; it is not a faster cold start for large netlists.
+netlist* netlist_image_loader(const char *data, size_t size) {
+	size_t ONE = 1;
+	const netlist_image_header *header = (const netlist_image_header*) data;
+	if (size < sizeof(netlist_image_header) || header->version != NETLIST_IMAGE_VERSION || header->num_of_inputs >= 64) {
+		return NULL;
+	}
+	size_t num_of_inputs = header->num_of_inputs;
+	size_t num_of_outputs = header->num_of_outputs;
+	size_t num_of_signals = header->num_of_signals;
+	size_t num_of_gates = header->num_of_gates;
+	size_t num_of_words = header->num_of_words;
+	size_t max_num_of_words = size / sizeof(uint64_t);
+	size_t max_num_of_ids = size / sizeof(uint32_t);
+	size_t position = sizeof(netlist_image_header);
+	// Every count sizes a section of 32-bit ids, so none can exceed the number of ids the file holds;
+	// that keeps the section sizes derived from them below from wrapping around.
+	if (num_of_signals > max_num_of_ids || num_of_outputs > max_num_of_ids || num_of_gates > max_num_of_ids || header->num_of_pins > max_num_of_ids) {
+		return NULL;
+	}
+	if (num_of_words != ((ONE << num_of_inputs) + 63) / 64 || (num_of_outputs > 0 && num_of_words > max_num_of_words / num_of_outputs)) {
+		return NULL;
+	}
+	const uint32_t *signal_name_offsets = netlist_image_section(data, size, &position, num_of_signals + 1, sizeof(uint32_t));
+	const char *signal_names = netlist_image_section(data, size, &position, header->signal_names_size, sizeof(char));
+	const uint32_t *output_name_offsets = netlist_image_section(data, size, &position, num_of_outputs + 1, sizeof(uint32_t));
+	const char *output_names = netlist_image_section(data, size, &position, header->output_names_size, sizeof(char));
+	const uint32_t *gate_types = netlist_image_section(data, size, &position, num_of_gates, sizeof(uint32_t));
+	const uint32_t *gate_pin_counts = netlist_image_section(data, size, &position, num_of_gates * 3, sizeof(uint32_t));
+	const uint32_t *gate_pin_offsets = netlist_image_section(data, size, &position, num_of_gates + 1, sizeof(uint32_t));
+	const uint32_t *gate_pins = netlist_image_section(data, size, &position, header->num_of_pins, sizeof(uint32_t));
+	const uint64_t *output_words = netlist_image_section(data, size, &position, num_of_outputs * num_of_words, sizeof(uint64_t));
+	if (output_words == NULL || num_of_signals < num_of_inputs + 2) {
+		return NULL;
+	}
+	if (!netlist_image_strings_are_valid(signal_name_offsets, signal_names, num_of_signals, header->signal_names_size)) {
+		return NULL;
+	}
+	if (!netlist_image_strings_are_valid(output_name_offsets, output_names, num_of_outputs, header->output_names_size)) {
+		return NULL;
+	}
+	if (!netlist_image_gates_are_valid(gate_types, gate_pin_counts, gate_pin_offsets, gate_pins, num_of_gates, header->num_of_pins, num_of_signals)) {
+		return NULL;
+	}
+	netlist *netlist = netlist_constructor();
+	input_value *input_value = netlist->input_value;
+	output_value *output_value = netlist->output_value;
+	circuit *circuit = netlist->circuit;
+	signal_table *signals = circuit->signals;
+	signals->names = malloc(sizeof(char*) * num_of_signals);
+	signals->defined = malloc(sizeof(bool) * num_of_signals);
+	for (size_t i = 0; i < num_of_signals; i++) {
+		signals->names[i] = netlist_image_string(signal_name_offsets, signal_names, i);
+		signals->defined[i] = i < num_of_inputs + 2;
+	}
+	signals->num_of_signals = num_of_signals;
+	signals->max_num_of_signals = num_of_signals;
+	signal_table_rehash(signals);
+	input_value_allocate_inputs(input_value, num_of_inputs);
+	for (size_t i = 0; i < num_of_inputs; i++) {
+		input_value->inputs[i]->input = netlist_image_string(signal_name_offsets, signal_names, i);
+	}
+	input_value->first = (header->flags & NETLIST_IMAGE_INPUTVAR_FIRST) != 0;
+	input_value->num_of_signals = num_of_signals;
+	output_value_allocate_outputs(output_value, num_of_outputs);
+	for (size_t i = 0; i < num_of_outputs; i++) {
+		output_value->outputs[i]->output = netlist_image_string(output_name_offsets, output_names, i);
+		output_value->gen_outputs[i]->output = netlist_image_string(output_name_offsets, output_names, i);
+	}
+	output_value_allocate_values(output_value, input_value);
+	for (size_t i = 0; i < num_of_outputs; i++) {
+		output *output = output_value->outputs[i];
+		const uint64_t *words = output_words + i * num_of_words;
+		memcpy(output->words, words, sizeof(uint64_t) * num_of_words);
+		output->words[num_of_words - 1] &= get_word_mask(output->num_of_values, num_of_words - 1);
+	}
+	size_t num_of_other_gates = 0;
+	circuit->gates = malloc(sizeof(gate*) * num_of_gates);
+	circuit->max_num_of_gates = num_of_gates;
+	for (size_t i = 0; i < num_of_gates; i++) {
+		size_t gate_index = circuit_add_gate(circuit);
+		input_output *IO = circuit->gates[gate_index]->input_output;
+		circuit->gates[gate_index]->type = (gate_type) gate_types[i];
+		if (circuit->gates[gate_index]->type == OTHER) {
+			num_of_other_gates++;
+		}
+		IO->num_of_inputs = gate_pin_counts[i * 3];
+		IO->num_of_selectors = gate_pin_counts[i * 3 + 1];
+		IO->num_of_outputs = gate_pin_counts[i * 3 + 2];
+		IO->inputs = malloc(sizeof(char*) * IO->num_of_inputs);
+		IO->selectors = malloc(sizeof(char*) * IO->num_of_selectors);
+		IO->outputs = malloc(sizeof(char*) * IO->num_of_outputs);
+		IO->input_ids = malloc(sizeof(size_t) * IO->num_of_inputs);
+		IO->selector_ids = malloc(sizeof(size_t) * IO->num_of_selectors);
+		IO->output_ids = malloc(sizeof(size_t) * IO->num_of_outputs);
+		const uint32_t *pins = gate_pins + gate_pin_offsets[i];
+		for (size_t j = 0; j < IO->num_of_inputs; j++) {
+			IO->input_ids[j] = pins[j];
+			IO->inputs[j] = netlist_image_string(signal_name_offsets, signal_names, pins[j]);
+		}
+		pins += IO->num_of_inputs;
+		for (size_t j = 0; j < IO->num_of_selectors; j++) {
+			IO->selector_ids[j] = pins[j];
+			IO->selectors[j] = netlist_image_string(signal_name_offsets, signal_names, pins[j]);
+		}
+		pins += IO->num_of_selectors;
+		for (size_t j = 0; j < IO->num_of_outputs; j++) {
+			IO->output_ids[j] = pins[j];
+			IO->outputs[j] = netlist_image_string(signal_name_offsets, signal_names, pins[j]);
+			signals->defined[pins[j]] = true;
+		}
+	}
+	gen_other_gate_indices(circuit, num_of_other_gates);
+	gen_output_slots(circuit, output_value);
+	circuit->compiled_netlist = compiled_netlist_builder(circuit, input_value->num_of_inputs, signals->num_of_signals);
+	input_value->num_of_signals = circuit->compiled_netlist->num_of_signals;
+	circuit->bytecode = bytecode_builder(circuit);
+	return netlist;
+}
+
+void input_output_add_other_pins(input_output *IO, token *tokens, signal_table *signals) {
+	size_t num_of_total_vars = token_to_size(tokens[1]);
+	size_t num_of_other_inputs = 0;
+	size_t num_of_other_outputs = 0;
+	for (size_t i = 0; i < num_of_total_vars; i++) {
+		if (signal_table_is_defined(signals, tokens[2 + i].start, tokens[2 + i].length)) {
+			num_of_other_inputs++;
+		} else {
+			num_of_other_outputs++;
+		}
+	}
+	IO->num_of_inputs = num_of_other_inputs;
+	IO->num_of_outputs = num_of_other_outputs;
+	IO->inputs = malloc(sizeof(char*) * num_of_other_inputs);
+	IO->outputs = malloc(sizeof(char*) * num_of_other_outputs);
+	size_t input_counter = 0;
+	size_t output_counter = 0;
+	for (size_t i = 0; i < num_of_total_vars; i++) {
+		if (signal_table_is_defined(signals, tokens[2 + i].start, tokens[2 + i].length)) {
+			IO->inputs[input_counter] = token_to_string(tokens[2 + i]);
+			input_counter++;
+		} else {
+			IO->outputs[output_counter] = token_to_string(tokens[2 + i]);
+			output_counter++;
+			signal_table_define(signals, tokens[2 + i].start, tokens[2 + i].length);
+		}
+	}
+	input_output_intern(IO, signals);
+}
+
+netlist* netlist_builder(char *file) {
+	tokenizer *tokenizer = tokenizer_open(file);
+	if (tokenizer == NULL) {
+		return NULL;
+	}
+	if (netlist_image_has_magic(tokenizer->data, tokenizer->size)) {
+		netlist *netlist = netlist_image_loader(tokenizer->data, tokenizer->size);
+		tokenizer = tokenizer_free(tokenizer, false);
+		return netlist;
+	}
+	netlist *netlist = netlist_constructor();
+	input_value *input_value = netlist->input_value;
+	output_value *output_value = netlist->output_value;
+	circuit *circuit = netlist->circuit;
+	signal_table *signals = circuit->signals;
+	size_t num_of_output_vars = 0;
+	size_t num_of_other_gates = 0;
+	size_t max_num_of_other_gates = 0;
+	size_t *other_gate_lines = NULL;
+	size_t line_counter = 0;
+	size_t next_line = tokenizer->position;
+	while (tokenizer_next_line(tokenizer)) {
+		size_t line = next_line;
+		next_line = tokenizer->position;
+		if (tokenizer->num_of_tokens == 0) {
+			continue;
+		}
+		token *tokens = tokenizer->tokens;
+		line_counter++;
+		if (token_equals(tokens[0], "INPUTVAR")) {
+			input_value_add_primary_inputs(input_value, tokens, signals);
+			if (line_counter == 1) {
+				input_value->first = true;
+			}
+			continue;
+		}
+		if (token_equals(tokens[0], "OUTPUTVAR")) {
+			output_value_add_output_vars(output_value, tokens);
+			num_of_output_vars = output_value->num_of_outputs;
+			continue;
+		}
+		if (line_counter == 3) {
+			output_value_allocate_values(output_value, input_value);
+			continue;
+		}
+		if (line_counter <= 3 + num_of_output_vars) {
+			output_value_add_row(output_value, tokens, line_counter - 4);
+			continue;
+		}
+		size_t gate_index = circuit_add_gate(circuit);
+		input_output *IO = circuit->gates[gate_index]->input_output;
+		if (token_equals(tokens[0], "OR")) {
+			circuit->gates[gate_index]->type = OR;
+			IO->num_of_inputs = 2;
+			IO->num_of_outputs = 1;
+			IO->inputs = malloc(sizeof(char*) * 2);
+			IO->outputs = malloc(sizeof(char*) * 1);
+			IO->inputs[0] = token_to_string(tokens[1]);
+			IO->inputs[1] = token_to_string(tokens[2]);
+			IO->outputs[0] = token_to_string(tokens[3]);
+			input_output_intern(IO, signals);
+			continue;
+		}
+		if (token_equals(tokens[0], "AND")) {
+			circuit->gates[gate_index]->type = AND;
+			IO->num_of_inputs = 2;
+			IO->num_of_outputs = 1;
+			IO->inputs = malloc(sizeof(char*) * 2);
+			IO->outputs = malloc(sizeof(char*) * 1);
+			IO->inputs[0] = token_to_string(tokens[1]);
+			IO->inputs[1] = token_to_string(tokens[2]);
+			IO->outputs[0] = token_to_string(tokens[3]);
+			input_output_intern(IO, signals);
+			continue;
+		}
+		if (token_equals(tokens[0], "XOR")) {
+			circuit->gates[gate_index]->type = XOR;
+			IO->num_of_inputs = 2;
+			IO->num_of_outputs = 1;
+			IO->inputs = malloc(sizeof(char*) * 2);
+			IO->outputs = malloc(sizeof(char*) * 1);
+			IO->inputs[0] = token_to_string(tokens[1]);
+			IO->inputs[1] = token_to_string(tokens[2]);
+			IO->outputs[0] = token_to_string(tokens[3]);
+			input_output_intern(IO, signals);
+			continue;
+		}
+		if (token_equals(tokens[0], "NOT")) {
+			circuit->gates[gate_index]->type = NOT;
+			IO->num_of_inputs = 1;
+			IO->num_of_outputs = 1;
+			IO->inputs = malloc(sizeof(char*) * 1);
+			IO->outputs = malloc(sizeof(char*) * 1);
+			IO->inputs[0] = token_to_string(tokens[1]);
+			IO->outputs[0] = token_to_string(tokens[2]);
+			input_output_intern(IO, signals);
+			continue;
+		}
+		if (token_equals(tokens[0], "DECODER")) {
+			circuit->gates[gate_index]->type = DECODER;
+			size_t ONE = 1;
+			size_t num_of_decoder_inputs = token_to_size(tokens[1]);
+			size_t num_of_decoder_outputs = ONE << num_of_decoder_inputs;
+			IO->num_of_inputs = num_of_decoder_inputs;
+			IO->num_of_outputs = num_of_decoder_outputs;
+			IO->inputs = malloc(sizeof(char*) * num_of_decoder_inputs);
+			IO->outputs = malloc(sizeof(char*) * num_of_decoder_outputs);
+			for (size_t i = 0; i < num_of_decoder_inputs; i++) {
+				IO->inputs[i] = token_to_string(tokens[2 + i]);
+			}
+			for (size_t i = 0; i < num_of_decoder_outputs; i++) {
+				IO->outputs[i] = token_to_string(tokens[2 + num_of_decoder_inputs + i]);
+			}
+			input_output_intern(IO, signals);
+			continue;
+		}
+		if (token_equals(tokens[0], "MULTIPLEXER")) {
+			circuit->gates[gate_index]->type = MULTIPLEXER;
+			size_t num_of_multi_inputs = token_to_size(tokens[1]);
+			size_t num_of_multi_selectors = logarithm_base_2_floored(num_of_multi_inputs);
+			IO->num_of_inputs = num_of_multi_inputs;
+			IO->num_of_outputs = 1;
+			IO->num_of_selectors = num_of_multi_selectors;
+			IO->inputs = malloc(sizeof(char*) * num_of_multi_inputs);
+			IO->outputs = malloc(sizeof(char*) * 1);
+			IO->selectors = malloc(sizeof(char*) * num_of_multi_selectors);
+			for (size_t i = 0; i < num_of_multi_inputs; i++) {
+				IO->inputs[i] = token_to_string(tokens[2 + i]);
+			}
+			for (size_t i = 0; i < num_of_multi_selectors; i++) {
+				IO->selectors[i] = token_to_string(tokens[2 + num_of_multi_inputs + i]);
+			}
+			IO->outputs[0] = token_to_string(tokens[2 + num_of_multi_inputs + num_of_multi_selectors]);
+			input_output_intern(IO, signals);
+			continue;
+		}
+		// an unknown gate's pins are split into inputs and outputs by what the rest of the netlist drives,
+		// so it is only read once every known gate has been seen
+		if (num_of_other_gates == max_num_of_other_gates) {
+			max_num_of_other_gates = (num_of_other_gates == 0) ? 16 : num_of_other_gates * 2;
+			other_gate_lines = realloc(other_gate_lines, sizeof(size_t) * max_num_of_other_gates);
+		}
+		other_gate_lines[num_of_other_gates] = line;
+		num_of_other_gates++;
+		circuit->gates[gate_index]->type = OTHER;
+	}
+	for (size_t k = 0, z = 0; k < circuit->num_of_gates; k++) {
+		if (circuit->gates[k]->type != OTHER) {
+			continue;
+		}
+		tokenizer->position = other_gate_lines[z];
+		z++;
+		tokenizer_next_line(tokenizer);
+		input_output_add_other_pins(circuit->gates[k]->input_output, tokenizer->tokens, signals);
+	}
+	other_gate_lines = Free(other_gate_lines);
+	tokenizer = tokenizer_free(tokenizer, false);
+	gen_other_gate_indices(circuit, num_of_other_gates);
+	gen_output_slots(circuit, output_value);
+	circuit->compiled_netlist = compiled_netlist_builder(circuit, input_value->num_of_inputs, signals->num_of_signals);
+	input_value->num_of_signals = circuit->compiled_netlist->num_of_signals;
+	circuit->bytecode = bytecode_builder(circuit);
+	return netlist;
+}
+
+size_t get_netlist_image_strings_size(char **strings, size_t num_of_strings) {
+	size_t strings_size = 0;
+	for (size_t i = 0; i < num_of_strings; i++) {
+		strings_size += strlen(strings[i]) + 1;
+	}
+	return strings_size;
+}
+
+// Writes one section and pads it with zeros to a multiple of 8 bytes, as netlist_image_section expects.
+void netlist_image_write_section(FILE *fp, const void *elements, size_t num_of_elements, size_t element_size) {
+	fwrite(elements, element_size, num_of_elements, fp);
+	for (size_t i = num_of_elements * element_size; i % 8 != 0; i++) {
+		fputc('\0', fp);
+	}
+}
+
+void netlist_image_write_strings(FILE *fp, char **strings, size_t num_of_strings, size_t strings_size) {
+	uint32_t *offsets = malloc(sizeof(uint32_t) * (num_of_strings + 1));
+	offsets[0] = 0;
+	for (size_t i = 0; i < num_of_strings; i++) {
+		offsets[i + 1] = offsets[i] + strlen(strings[i]) + 1;
+	}
+	netlist_image_write_section(fp, offsets, num_of_strings + 1, sizeof(uint32_t));
+	for (size_t i = 0; i < num_of_strings; i++) {
+		fwrite(strings[i], sizeof(char), strlen(strings[i]) + 1, fp);
+	}
+	for (size_t i = strings_size; i % 8 != 0; i++) {
+		fputc('\0', fp);
+	}
+	offsets = Free(offsets);
+}
+
+// Ids, pin counts and string offsets are stored as 32-bit words to keep the image compact, so a netlist
+// whose signals, pins or names do not fit in 32 bits is not written.
+bool netlist_writer(netlist *netlist, char *file) {
+	size_t ONE = 1;
+	input_value *input_value = netlist->input_value;
+	output_value *output_value = netlist->output_value;
+	circuit *circuit = netlist->circuit;
+	signal_table *signals = circuit->signals;
+	size_t num_of_signals = signals->num_of_signals;
+	size_t num_of_gates = circuit->num_of_gates;
+	size_t num_of_outputs = output_value->num_of_outputs;
+	char **output_names = malloc(sizeof(char*) * num_of_outputs);
+	for (size_t i = 0; i < num_of_outputs; i++) {
+		output_names[i] = output_value->outputs[i]->output;
+	}
+	size_t num_of_pins = 0;
+	for (size_t i = 0; i < num_of_gates; i++) {
+		input_output *IO = circuit->gates[i]->input_output;
+		num_of_pins += IO->num_of_inputs + IO->num_of_selectors + IO->num_of_outputs;
+	}
+	size_t signal_names_size = get_netlist_image_strings_size(signals->names, num_of_signals);
+	size_t output_names_size = get_netlist_image_strings_size(output_names, num_of_outputs);
+	FILE *fp = NULL;
+	if (num_of_pins > UINT32_MAX || signal_names_size > UINT32_MAX || output_names_size > UINT32_MAX || (fp = fopen(file, "wb")) == NULL) {
+		output_names = Free(output_names);
+		return false;
+	}
+	uint32_t *gate_types = malloc(sizeof(uint32_t) * num_of_gates);
+	uint32_t *gate_pin_counts = malloc(sizeof(uint32_t) * num_of_gates * 3);
+	uint32_t *gate_pin_offsets = malloc(sizeof(uint32_t) * (num_of_gates + 1));
+	uint32_t *gate_pins = malloc(sizeof(uint32_t) * num_of_pins);
+	uint32_t *pins = gate_pins;
+	for (size_t i = 0; i < num_of_gates; i++) {
+		input_output *IO = circuit->gates[i]->input_output;
+		gate_types[i] = circuit->gates[i]->type;
+		gate_pin_counts[i * 3] = IO->num_of_inputs;
+		gate_pin_counts[i * 3 + 1] = IO->num_of_selectors;
+		gate_pin_counts[i * 3 + 2] = IO->num_of_outputs;
+		gate_pin_offsets[i] = pins - gate_pins;
+		for (size_t j = 0; j < IO->num_of_inputs; j++) {
+			*pins++ = IO->input_ids[j];
+		}
+		for (size_t j = 0; j < IO->num_of_selectors; j++) {
+			*pins++ = IO->selector_ids[j];
+		}
+		for (size_t j = 0; j < IO->num_of_outputs; j++) {
+			*pins++ = IO->output_ids[j];
+		}
+	}
+	gate_pin_offsets[num_of_gates] = num_of_pins;
+	for (size_t i = 0; i < circuit->num_of_other_gates; i++) {
+		gate_types[circuit->other_gate_indices[i]] = OTHER;
+	}
+	netlist_image_header header;
+	memset(&header, 0, sizeof(netlist_image_header));
+	memcpy(header.magic, NETLIST_IMAGE_MAGIC, sizeof(NETLIST_IMAGE_MAGIC));
+	header.version = NETLIST_IMAGE_VERSION;
+	header.flags = input_value->first ? NETLIST_IMAGE_INPUTVAR_FIRST : 0;
+	header.num_of_inputs = input_value->original_num_of_inputs;
+	header.num_of_outputs = num_of_outputs;
+	header.num_of_signals = num_of_signals;
+	header.num_of_gates = num_of_gates;
+	header.num_of_pins = num_of_pins;
+	header.num_of_words = ((ONE << header.num_of_inputs) + 63) / 64;
+	header.signal_names_size = signal_names_size;
+	header.output_names_size = output_names_size;
+	fwrite(&header, sizeof(netlist_image_header), 1, fp);
+	netlist_image_write_strings(fp, signals->names, num_of_signals, signal_names_size);
+	netlist_image_write_strings(fp, output_names, num_of_outputs, output_names_size);
+	netlist_image_write_section(fp, gate_types, num_of_gates, sizeof(uint32_t));
+	netlist_image_write_section(fp, gate_pin_counts, num_of_gates * 3, sizeof(uint32_t));
+	netlist_image_write_section(fp, gate_pin_offsets, num_of_gates + 1, sizeof(uint32_t));
+	netlist_image_write_section(fp, gate_pins, num_of_pins, sizeof(uint32_t));
+	for (size_t i = 0; i < num_of_outputs; i++) {
+		netlist_image_write_section(fp, output_value->outputs[i]->words, header.num_of_words, sizeof(uint64_t));
+	}
+	bool is_success = ferror(fp) == 0;
+	is_success = (fclose(fp) == 0) && is_success;
+	fp = NULL;
+	output_names = Free(output_names);
+	gate_types = Free(gate_types);
+	gate_pin_counts = Free(gate_pin_counts);
+	gate_pin_offsets = Free(gate_pin_offsets);
+	gate_pins = Free(gate_pins);
+	return is_success;
+}
+
+void plane_or_scalar(uint64_t *result, const uint64_t *input_1, const uint64_t *input_2, size_t num_of_words) {
+	for (size_t i = 0; i < num_of_words; i++) {
+		result[i] = input_1[i] | input_2[i];
+	}
+}
+
+void plane_and_scalar(uint64_t *result, const uint64_t *input_1, const uint64_t *input_2, size_t num_of_words) {
+	for (size_t i = 0; i < num_of_words; i++) {
+		result[i] = input_1[i] & input_2[i];
+	}
+}
+
+void plane_xor_scalar(uint64_t *result, const uint64_t *input_1, const uint64_t *input_2, size_t num_of_words) {
+	for (size_t i = 0; i < num_of_words; i++) {
+		result[i] = input_1[i] ^ input_2[i];
+	}
+}
+
+void plane_and_not_scalar(uint64_t *result, const uint64_t *input_1, const uint64_t *input_2, size_t num_of_words) {
+	for (size_t i = 0; i < num_of_words; i++) {
+		result[i] = input_1[i] & ~input_2[i];
+	}
+}
+
+void plane_not_scalar(uint64_t *result, const uint64_t *input_1, size_t num_of_words) {
+	for (size_t i = 0; i < num_of_words; i++) {
+		result[i] = ~input_1[i];
+	}
+}
+
+#ifdef PLANE_KERNELS_X86
+__attribute__((target("avx2")))
+void plane_or_avx2(uint64_t *result, const uint64_t *input_1, const uint64_t *input_2, size_t num_of_words) {
+	size_t i = 0;
+	for (; i + 4 <= num_of_words; i += 4) {
+		__m256i a = _mm256_loadu_si256((const __m256i *) (input_1 + i));
+		__m256i b = _mm256_loadu_si256((const __m256i *) (input_2 + i));
+		_mm256_storeu_si256((__m256i *) (result + i), _mm256_or_si256(a, b));
+	}
+	plane_or_scalar(result + i, input_1 + i, input_2 + i, num_of_words - i);
+}
+
+__attribute__((target("avx2")))
+void plane_and_avx2(uint64_t *result, const uint64_t *input_1, const uint64_t *input_2, size_t num_of_words) {
+	size_t i = 0;
+	for (; i + 4 <= num_of_words; i += 4) {
+		__m256i a = _mm256_loadu_si256((const __m256i *) (input_1 + i));
+		__m256i b = _mm256_loadu_si256((const __m256i *) (input_2 + i));
+		_mm256_storeu_si256((__m256i *) (result + i), _mm256_and_si256(a, b));
+	}
+	plane_and_scalar(result + i, input_1 + i, input_2 + i, num_of_words - i);
+}
+
+__attribute__((target("avx2")))
+void plane_xor_avx2(uint64_t *result, const uint64_t *input_1, const uint64_t *input_2, size_t num_of_words) {
+	size_t i = 0;
+	for (; i + 4 <= num_of_words; i += 4) {
+		__m256i a = _mm256_loadu_si256((const __m256i *) (input_1 + i));
+		__m256i b = _mm256_loadu_si256((const __m256i *) (input_2 + i));
+		_mm256_storeu_si256((__m256i *) (result + i), _mm256_xor_si256(a, b));
+	}
+	plane_xor_scalar(result + i, input_1 + i, input_2 + i, num_of_words - i);
+}
+
+__attribute__((target("avx2")))
+void plane_and_not_avx2(uint64_t *result, const uint64_t *input_1, const uint64_t *input_2, size_t num_of_words) {
+	size_t i = 0;
+	for (; i + 4 <= num_of_words; i += 4) {
+		__m256i a = _mm256_loadu_si256((const __m256i *) (input_1 + i));
+		__m256i b = _mm256_loadu_si256((const __m256i *) (input_2 + i));
+		_mm256_storeu_si256((__m256i *) (result + i), _mm256_andnot_si256(b, a));
+	}
+	plane_and_not_scalar(result + i, input_1 + i, input_2 + i, num_of_words - i);
+}
+
+__attribute__((target("avx2")))
+void plane_not_avx2(uint64_t *result, const uint64_t *input_1, size_t num_of_words) {
+	size_t i = 0;
+	__m256i ones = _mm256_set1_epi64x(-1);
+	for (; i + 4 <= num_of_words; i += 4) {
+		__m256i a = _mm256_loadu_si256((const __m256i *) (input_1 + i));
+		_mm256_storeu_si256((__m256i *) (result + i), _mm256_xor_si256(a, ones));
+	}
+	plane_not_scalar(result + i, input_1 + i, num_of_words - i);
+}
+
+__attribute__((target("avx512f")))
+void plane_or_avx512(uint64_t *result, const uint64_t *input_1, const uint64_t *input_2, size_t num_of_words) {
+	size_t i = 0;
+	for (; i + 8 <= num_of_words; i += 8) {
+		__m512i a = _mm512_loadu_si512((const void *) (input_1 + i));
+		__m512i b = _mm512_loadu_si512((const void *) (input_2 + i));
+		_mm512_storeu_si512((void *) (result + i), _mm512_or_si512(a, b));
+	}
+	plane_or_scalar(result + i, input_1 + i, input_2 + i, num_of_words - i);
+}
+
+__attribute__((target("avx512f")))
+void plane_and_avx512(uint64_t *result, const uint64_t *input_1, const uint64_t *input_2, size_t num_of_words) {
+	size_t i = 0;
+	for (; i + 8 <= num_of_words; i += 8) {
+		__m512i a = _mm512_loadu_si512((const void *) (input_1 + i));
+		__m512i b = _mm512_loadu_si512((const void *) (input_2 + i));
+		_mm512_storeu_si512((void *) (result + i), _mm512_and_si512(a, b));
+	}
+	plane_and_scalar(result + i, input_1 + i, input_2 + i, num_of_words - i);
+}
+
+__attribute__((target("avx512f")))
+void plane_xor_avx512(uint64_t *result, const uint64_t *input_1, const uint64_t *input_2, size_t num_of_words) {
+	size_t i = 0;
+	for (; i + 8 <= num_of_words; i += 8) {
+		__m512i a = _mm512_loadu_si512((const void *) (input_1 + i));
+		__m512i b = _mm512_loadu_si512((const void *) (input_2 + i));
+		_mm512_storeu_si512((void *) (result + i), _mm512_xor_si512(a, b));
+	}
+	plane_xor_scalar(result + i, input_1 + i, input_2 + i, num_of_words - i);
+}
+
+__attribute__((target("avx512f")))
+void plane_and_not_avx512(uint64_t *result, const uint64_t *input_1, const uint64_t *input_2, size_t num_of_words) {
+	size_t i = 0;
+	for (; i + 8 <= num_of_words; i += 8) {
+		__m512i a = _mm512_loadu_si512((const void *) (input_1 + i));
+		__m512i b = _mm512_loadu_si512((const void *) (input_2 + i));
+		_mm512_storeu_si512((void *) (result + i), _mm512_andnot_si512(b, a));
+	}
+	plane_and_not_scalar(result + i, input_1 + i, input_2 + i, num_of_words - i);
+}
+
+__attribute__((target("avx512f")))
+void plane_not_avx512(uint64_t *result, const uint64_t *input_1, size_t num_of_words) {
+	size_t i = 0;
+	__m512i ones = _mm512_set1_epi64(-1);
+	for (; i + 8 <= num_of_words; i += 8) {
+		__m512i a = _mm512_loadu_si512((const void *) (input_1 + i));
+		_mm512_storeu_si512((void *) (result + i), _mm512_xor_si512(a, ones));
+	}
+	plane_not_scalar(result + i, input_1 + i, num_of_words - i);
+}
+#endif
+
+void (*plane_or)(uint64_t *, const uint64_t *, const uint64_t *, size_t) = plane_or_scalar;
+void (*plane_and)(uint64_t *, const uint64_t *, const uint64_t *, size_t) = plane_and_scalar;
+void (*plane_xor)(uint64_t *, const uint64_t *, const uint64_t *, size_t) = plane_xor_scalar;
+void (*plane_and_not)(uint64_t *, const uint64_t *, const uint64_t *, size_t) = plane_and_not_scalar;
+void (*plane_not)(uint64_t *, const uint64_t *, size_t) = plane_not_scalar;
+
+void select_plane_kernels() {
+#ifdef PLANE_KERNELS_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f")) {
+		plane_or = plane_or_avx512;
+		plane_and = plane_and_avx512;
+		plane_xor = plane_xor_avx512;
+		plane_and_not = plane_and_not_avx512;
+		plane_not = plane_not_avx512;
+		return;
+	}
+	if (__builtin_cpu_supports("avx2")) {
+		plane_or = plane_or_avx2;
+		plane_and = plane_and_avx2;
+		plane_xor = plane_xor_avx2;
+		plane_and_not = plane_and_not_avx2;
+		plane_not = plane_not_avx2;
+		return;
+	}
+#endif
+}
+
+// Packs each primary input's column of the truth table into words. Row j holds the pattern j, so every
+// column is a square wave computed from the row index alone.
+void gen_input_words(input_value *input_value) {
+	size_t ONE = 1;
+	size_t num_of_bits = input_value->original_num_of_inputs;
+	size_t num_of_outcomes = ONE << num_of_bits;
+	size_t num_of_block_words = get_num_of_block_words(num_of_outcomes);
+	size_t num_of_padded_words = get_num_of_padded_words(num_of_outcomes);
+	input_value->num_of_block_words = num_of_block_words;
+	input_value->num_of_blocks = num_of_padded_words / num_of_block_words;
+	input_value->input_words = calloc(num_of_bits * num_of_padded_words, sizeof(uint64_t));
+	for (size_t i = 0; i < num_of_bits; i++) {
+		size_t bit_counter = num_of_bits - ONE - i;
+		uint64_t *words = input_value->input_words + i * num_of_padded_words;
+		for (size_t j = 0; j < num_of_outcomes; j++) {
+			uint64_t bit = (j >> bit_counter) & ONE;
+			words[j / 64] |= bit << (j % 64);
+		}
+	}
+	input_value->signal_values = calloc(input_value->num_of_signals * num_of_block_words, sizeof(uint64_t));
+	input_value->scratch_planes = calloc(MAX_NUM_OF_SELECT_BITS * num_of_block_words, sizeof(uint64_t));
+	input_value->probe_words = calloc(num_of_bits, sizeof(uint64_t));
+	input_value->is_signal_dirty = calloc(input_value->num_of_signals, sizeof(bool));
+	for (size_t i = num_of_bits; i < num_of_bits + 2; i++) {
+		if (input_value->inputs[i]->value != 0) {
+			memset(input_value->signal_values + i * num_of_block_words, 0xFF, sizeof(uint64_t) * num_of_block_words);
+		}
+	}
+	select_plane_kernels();
+}
+
+void reset_input_value(input_value *input_value, size_t index_of_block) {
+	size_t num_of_bits = input_value->original_num_of_inputs;
+	size_t num_of_block_words = input_value->num_of_block_words;
+	size_t num_of_padded_words = input_value->num_of_blocks * num_of_block_words;
+	if (index_of_block == PROBE_BLOCK) {
+		input_value->num_of_active_words = 1;
+		for (size_t i = 0; i < num_of_bits; i++) {
+			input_value->signal_values[i * num_of_block_words] = input_value->probe_words[i];
+		}
+		return;
+	}
+	input_value->num_of_active_words = num_of_block_words;
+	for (size_t i = 0; i < num_of_bits; i++) {
+		uint64_t *words = input_value->input_words + i * num_of_padded_words + index_of_block * num_of_block_words;
+		memcpy(input_value->signal_values + i * num_of_block_words, words, sizeof(uint64_t) * num_of_block_words);
+	}
+}
+
+void reset_output_value(output_value *output_value) {
+	size_t num_of_outputs = output_value->num_of_outputs;
+	for (size_t i = 0; i < num_of_outputs; i++) {
+		size_t num_of_words = output_value->gen_outputs[i]->num_of_words;
+		memset(output_value->gen_outputs[i]->words, 0, sizeof(uint64_t) * num_of_words);
+	}
+}
+
+bool final_output_block_matches(output_value *output_value, size_t index_of_output, size_t index_of_block) {
+	size_t num_of_values = output_value->outputs[index_of_output]->num_of_values;
+	size_t num_of_words = output_value->outputs[index_of_output]->num_of_words;
+	size_t first_word = index_of_block * output_value->num_of_block_words;
+	size_t last_word = first_word + output_value->num_of_block_words;
+	if (last_word > num_of_words) {
+		last_word = num_of_words;
+	}
+	uint64_t *gen_words = output_value->gen_outputs[index_of_output]->words;
+	uint64_t *words = output_value->outputs[index_of_output]->words;
+	for (size_t i = first_word; i < last_word; i++) {
+		uint64_t mismatch = (gen_words[i] ^ words[i]) & get_word_mask(num_of_values, i);
+		if (mismatch != 0) {
+			output_value->mismatch_row = i * 64 + (size_t) __builtin_ctzll(mismatch);
+			return false;
+		}
+	}
+	return true;
+}
+
+void add_killer_row(input_value *input_value, output_value *output_value) {
+	size_t ONE = 1;
+	size_t row = output_value->mismatch_row;
+	if (row == SIZE_MAX) {
+		return;
+	}
+	output_value->mismatch_row = SIZE_MAX;
+	size_t num_of_probe_rows = output_value->num_of_probe_rows;
+	size_t num_of_used_rows = (num_of_probe_rows < MAX_NUM_OF_PROBE_ROWS) ? num_of_probe_rows : MAX_NUM_OF_PROBE_ROWS;
+	for (size_t i = 0; i < num_of_used_rows; i++) {
+		if (output_value->probe_rows[i] == row) {
+			return;
+		}
+	}
+	size_t slot = num_of_probe_rows % MAX_NUM_OF_PROBE_ROWS;
+	uint64_t slot_bit = (uint64_t) ONE << slot;
+	output_value->probe_rows[slot] = row;
+	output_value->probe_mask |= slot_bit;
+	output_value->num_of_probe_rows++;
+	size_t num_of_bits = input_value->original_num_of_inputs;
+	size_t num_of_padded_words = input_value->num_of_blocks * input_value->num_of_block_words;
+	for (size_t i = 0; i < num_of_bits; i++) {
+		uint64_t bit = (input_value->input_words[i * num_of_padded_words + row / 64] >> (row % 64)) & ONE;
+		input_value->probe_words[i] = (input_value->probe_words[i] & ~slot_bit) | (bit << slot);
+	}
+	size_t num_of_outputs = output_value->num_of_outputs;
+	for (size_t i = 0; i < num_of_outputs; i++) {
+		uint64_t bit = (output_value->outputs[i]->words[row / 64] >> (row % 64)) & ONE;
+		output_value->probe_words[i] = (output_value->probe_words[i] & ~slot_bit) | (bit << slot);
+	}
+}
+
+bool gen_outputs_correct(output_value *output_value) {
+	size_t num_of_outputs = output_value->num_of_outputs;
+	for (size_t i = 0; i < num_of_outputs; i++) {
+		size_t num_of_values = output_value->gen_outputs[i]->num_of_values;
+		size_t num_of_words = output_value->gen_outputs[i]->num_of_words;
+		size_t num_of_full_words = num_of_values / 64;
+		uint64_t *gen_words = output_value->gen_outputs[i]->words;
+		uint64_t *words = output_value->outputs[i]->words;
+		if (memcmp(gen_words, words, sizeof(uint64_t) * num_of_full_words) != 0) {
+			return false;
+		}
+		if (num_of_full_words < num_of_words) {
+			uint64_t mask = get_word_mask(num_of_values, num_of_full_words);
+			if ((gen_words[num_of_full_words] & mask) != words[num_of_full_words]) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+uint64_t* get_plane_of_signal(size_t signal_id, input_value *input_value) {
+	return input_value->signal_values + signal_id * input_value->num_of_block_words;
+}
+
+bool update_final_output(size_t index_of_output, const uint64_t *plane, size_t index_of_block, output_value *output_value) {
+	size_t num_of_block_words = output_value->num_of_block_words;
+	if (index_of_block == PROBE_BLOCK) {
+		return ((plane[0] ^ output_value->probe_words[index_of_output]) & output_value->probe_mask) == 0;
+	}
+	memcpy(output_value->gen_outputs[index_of_output]->words + index_of_block * num_of_block_words, plane, sizeof(uint64_t) * num_of_block_words);
+	return final_output_block_matches(output_value, index_of_output, index_of_block);
+}
+
+// Outcome tables depend only on the number of select bits, so each width is built once per input_value
+// and reused by every DECODER and MULTIPLEXER evaluation after that. Cached tables also carry positions,
+// the index of the outcome that has each value.
+outcomes* get_cached_outcomes(input_value *input_value, size_t num_of_bits) {
+	size_t num_of_cached_outcomes = input_value->num_of_cached_outcomes;
+	if (num_of_bits >= num_of_cached_outcomes) {
+		input_value->cached_outcomes = realloc(input_value->cached_outcomes, sizeof(outcomes*) * (num_of_bits + 1));
+		for (size_t i = num_of_cached_outcomes; i <= num_of_bits; i++) {
+			input_value->cached_outcomes[i] = NULL;
+		}
+		input_value->num_of_cached_outcomes = num_of_bits + 1;
+	}
+	if (input_value->cached_outcomes[num_of_bits] == NULL) {
+		outcomes *outcomes = outcomes_builder(num_of_bits);
+		outcomes->positions = malloc(sizeof(size_t) * outcomes->num_of_outcomes);
+		for (size_t i = 0; i < outcomes->num_of_outcomes; i++) {
+			outcomes->positions[outcomes->outcomes[i]] = i;
+		}
+		input_value->cached_outcomes[num_of_bits] = outcomes;
+	}
+	return input_value->cached_outcomes[num_of_bits];
+}
+
+// Runs num_of_instructions consecutive instructions starting at code over the current block of planes.
+bool run_bytecode(const size_t *code, size_t num_of_instructions, input_value *input_value, output_value *output_value, size_t index_of_block) {
+	size_t ONE = 1;
+#ifdef BYTECODE_COMPUTED_GOTO
+	static void *handlers[] = {&&op_fail, &&op_or, &&op_and, &&op_xor, &&op_not, &&op_decoder, &&op_multiplexer};
+#endif
+	size_t num_of_words = input_value->num_of_active_words;
+	const size_t *pins = NULL;
+	const size_t *output_ids = NULL;
+	const size_t *output_slots = NULL;
+	uint64_t *result = NULL;
+	outcomes *outcomes = NULL;
+	size_t num_of_bits = 0;
+next_instruction:
+	if (num_of_instructions == 0) {
+		return true;
+	}
+	num_of_instructions--;
+	pins = code + BYTECODE_HEADER_WORDS;
+	output_ids = pins + code[1] + code[2];
+	output_slots = output_ids + code[3];
+#ifdef BYTECODE_COMPUTED_GOTO
+	goto *handlers[code[0]];
+#else
+	switch (code[0]) {
+		case OP_OR:
+			goto op_or;
+		case OP_AND:
+			goto op_and;
+		case OP_XOR:
+			goto op_xor;
+		case OP_NOT:
+			goto op_not;
+		case OP_DECODER:
+			goto op_decoder;
+		case OP_MULTIPLEXER:
+			goto op_multiplexer;
+		default:
+			goto op_fail;
+	}
+#endif
+op_fail:
+	return false;
+op_or:
+	result = get_plane_of_signal(output_ids[0], input_value);
+	plane_or(result, get_plane_of_signal(pins[0], input_value), get_plane_of_signal(pins[1], input_value), num_of_words);
+	goto publish_output;
+op_and:
+	result = get_plane_of_signal(output_ids[0], input_value);
+	plane_and(result, get_plane_of_signal(pins[0], input_value), get_plane_of_signal(pins[1], input_value), num_of_words);
+	goto publish_output;
+op_xor:
+	result = get_plane_of_signal(output_ids[0], input_value);
+	plane_xor(result, get_plane_of_signal(pins[0], input_value), get_plane_of_signal(pins[1], input_value), num_of_words);
+	goto publish_output;
+op_not:
+	result = get_plane_of_signal(output_ids[0], input_value);
+	plane_not(result, get_plane_of_signal(pins[0], input_value), num_of_words);
+	goto publish_output;
+op_decoder:
+	// The minterms are grown one input at a time and share their prefixes: after j inputs, the product
+	// for the leading bits p is held in the output whose value is p followed by zeros, and the next input
+	// splits it into that output and the one whose value has the next bit set. That is two plane
+	// operations per output instead of one per output and input.
+	num_of_bits = code[1];
+	outcomes = get_cached_outcomes(input_value, num_of_bits);
+	result = get_plane_of_signal(output_ids[outcomes->positions[ONE << (num_of_bits - ONE)]], input_value);
+	memcpy(result, get_plane_of_signal(pins[0], input_value), sizeof(uint64_t) * num_of_words);
+	plane_not(get_plane_of_signal(output_ids[outcomes->positions[0]], input_value), result, num_of_words);
+	for (size_t j = 1; j < num_of_bits; j++) {
+		uint64_t *input_j = get_plane_of_signal(pins[j], input_value);
+		for (size_t prefix = 0; prefix < (ONE << j); prefix++) {
+			uint64_t *product = get_plane_of_signal(output_ids[outcomes->positions[prefix << (num_of_bits - j)]], input_value);
+			result = get_plane_of_signal(output_ids[outcomes->positions[((prefix << ONE) | ONE) << (num_of_bits - ONE - j)]], input_value);
+			plane_and(result, product, input_j, num_of_words);
+			plane_and_not(product, product, input_j, num_of_words);
+		}
+	}
+	for (size_t i = 0; i < outcomes->num_of_outcomes; i++) {
+		if (output_slots[i] != NO_OUTPUT_SLOT && !update_final_output(output_slots[i], get_plane_of_signal(output_ids[i], input_value), index_of_block, output_value)) {
+			return false;
+		}
+	}
+	code = output_slots + code[3];
+	goto next_instruction;
+op_multiplexer:
+	// A tree of 2:1 selects over the data pins taken in selector value order, three plane operations per
+	// node. Pairs that differ in the last selector are merged first; the subtrees still waiting for a
+	// sibling are kept on a stack whose bottom entry is the output plane and whose depth is bounded by
+	// the number of selectors.
+	num_of_bits = code[4];
+	outcomes = get_cached_outcomes(input_value, num_of_bits);
+	result = get_plane_of_signal(output_ids[0], input_value);
+	for (size_t pair = 0, depth = 0; pair < (outcomes->num_of_outcomes >> ONE); pair++, depth++) {
+		uint64_t *node = (depth == 0) ? result : input_value->scratch_planes + depth * input_value->num_of_block_words;
+		uint64_t *low = get_plane_of_signal(pins[outcomes->positions[pair << ONE]], input_value);
+		uint64_t *high = get_plane_of_signal(pins[outcomes->positions[(pair << ONE) | ONE]], input_value);
+		uint64_t *selector = get_plane_of_signal(pins[code[5] + num_of_bits - ONE], input_value);
+		plane_xor(node, low, high, num_of_words);
+		plane_and(node, node, selector, num_of_words);
+		plane_xor(node, node, low, num_of_words);
+		for (size_t level = 1, merged = pair + 1; (merged & ONE) == 0; level++, merged >>= ONE) {
+			uint64_t *sibling = (depth == 1) ? result : input_value->scratch_planes + (depth - 1) * input_value->num_of_block_words;
+			selector = get_plane_of_signal(pins[code[5] + num_of_bits - ONE - level], input_value);
+			plane_xor(node, node, sibling, num_of_words);
+			plane_and(node, node, selector, num_of_words);
+			plane_xor(sibling, sibling, node, num_of_words);
+			depth--;
+			node = sibling;
+		}
+	}
+	goto publish_output;
+publish_output:
+	if (output_slots[0] != NO_OUTPUT_SLOT && !update_final_output(output_slots[0], result, index_of_block, output_value)) {
+		return false;
+	}
+	code = output_slots + code[3];
+	goto next_instruction;
+}
+
+int jit_publish(void *context, size_t index_of_output, const uint64_t *plane) {
+	jit_block *jit_block = context;
+	return update_final_output(index_of_output, plane, jit_block->index_of_block, jit_block->output_value);
+}
+
+bool run_jit_program(jit_program *jit_program, const size_t *code, input_value *input_value, output_value *output_value, size_t index_of_block) {
+	jit_block jit_block;
+	jit_block.output_value = output_value;
+	jit_block.index_of_block = index_of_block;
+	return jit_program->function(input_value->signal_values, input_value->num_of_block_words, input_value->num_of_active_words, code, jit_publish, &jit_block) != 0;
+}
+
+bool signal_is_dirty(const bool *is_signal_dirty, const size_t *ids, size_t num_of_ids) {
+	for (size_t i = 0; i < num_of_ids; i++) {
+		if (is_signal_dirty[ids[i]]) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Returns room to keep num_of_planes block planes, grown on demand and reused across blocks.
+uint64_t* get_step_planes(input_value *input_value, size_t num_of_planes) {
+	if (num_of_planes > input_value->num_of_step_planes) {
+		input_value->step_planes = realloc(input_value->step_planes, sizeof(uint64_t) * num_of_planes * input_value->num_of_block_words);
+		input_value->num_of_step_planes = num_of_planes;
+	}
+	return input_value->step_planes;
+}
+
+// Carries the planes of the previous block over to this one: only the primary inputs whose words differ
+// are rewritten and only the gates downstream of them are evaluated again. Under Gray ordering at most
+// two inputs change from one block to the next; final outputs of untouched gates are only republished.
+// A gate that is evaluated again only dirties the outputs whose planes actually changed, so the event
+// stops at the first gate whose result is the same as in the previous block.
+bool step_gates(bytecode *bytecode, input_value *input_value, output_value *output_value, size_t index_of_block) {
+	compiled_netlist *compiled_netlist = bytecode->compiled_netlist;
+	size_t num_of_gates = compiled_netlist->num_of_gates;
+	size_t num_of_bits = input_value->original_num_of_inputs;
+	size_t num_of_block_words = input_value->num_of_block_words;
+	size_t num_of_padded_words = input_value->num_of_blocks * num_of_block_words;
+	bool *is_signal_dirty = input_value->is_signal_dirty;
+	input_value->num_of_active_words = num_of_block_words;
+	for (size_t i = 0; i < num_of_bits; i++) {
+		uint64_t *words = input_value->input_words + i * num_of_padded_words + index_of_block * num_of_block_words;
+		uint64_t *plane = get_plane_of_signal(i, input_value);
+		if (memcmp(plane, words, sizeof(uint64_t) * num_of_block_words) != 0) {
+			memcpy(plane, words, sizeof(uint64_t) * num_of_block_words);
+			is_signal_dirty[i] = true;
+		}
+	}
+	bool is_success = true;
+	for (size_t k = 0; k < num_of_gates && is_success; k++) {
+		compiled_gate IO = get_compiled_gate(compiled_netlist, k);
+		if (signal_is_dirty(is_signal_dirty, IO.input_ids, IO.num_of_inputs) || signal_is_dirty(is_signal_dirty, IO.selector_ids, IO.num_of_selectors)) {
+			uint64_t *step_planes = get_step_planes(input_value, IO.num_of_outputs);
+			for (size_t i = 0; i < IO.num_of_outputs; i++) {
+				memcpy(step_planes + i * num_of_block_words, get_plane_of_signal(IO.output_ids[i], input_value), sizeof(uint64_t) * num_of_block_words);
+			}
+			is_success = run_bytecode(bytecode->code + bytecode->instruction_offsets[k], 1, input_value, output_value, index_of_block);
+			for (size_t i = 0; i < IO.num_of_outputs; i++) {
+				if (memcmp(step_planes + i * num_of_block_words, get_plane_of_signal(IO.output_ids[i], input_value), sizeof(uint64_t) * num_of_block_words) != 0) {
+					is_signal_dirty[IO.output_ids[i]] = true;
+				}
+			}
+			continue;
+		}
+		for (size_t i = 0; i < IO.num_of_outputs && is_success; i++) {
+			if (IO.output_slots[i] != NO_OUTPUT_SLOT) {
+				is_success = update_final_output(IO.output_slots[i], get_plane_of_signal(IO.output_ids[i], input_value), index_of_block, output_value);
+			}
+		}
+	}
+	memset(is_signal_dirty, 0, sizeof(bool) * input_value->num_of_signals);
+	return is_success;
+}
+
+// Native code only leaves the planes of final outputs behind, so a block run by it is never stepped from.
+bool evaluate_gates(bytecode *bytecode, input_value *input_value, output_value *output_value, size_t index_of_block) {
+	bool is_success = false;
+	if (bytecode->jit_program != NULL) {
+		reset_input_value(input_value, index_of_block);
+		input_value->stepped_block = SIZE_MAX;
+		return run_jit_program(bytecode->jit_program, bytecode->code, input_value, output_value, index_of_block);
+	}
+	if (index_of_block != PROBE_BLOCK && index_of_block > 0 && input_value->stepped_block == index_of_block - 1) {
+		is_success = step_gates(bytecode, input_value, output_value, index_of_block);
+	} else {
+		reset_input_value(input_value, index_of_block);
+		is_success = run_bytecode(bytecode->code, bytecode->num_of_gates, input_value, output_value, index_of_block);
+	}
+	input_value->stepped_block = (is_success && index_of_block != PROBE_BLOCK) ? index_of_block : SIZE_MAX;
+	return is_success;
+}
+
+bool signal_cache_fits(input_value *input_value, size_t num_of_caches) {
+	size_t num_of_padded_words = input_value->num_of_blocks * input_value->num_of_block_words;
+	return input_value->num_of_signals * num_of_padded_words * num_of_caches <= MAX_NUM_OF_CACHED_WORDS;
+}
+
+signal_cache* signal_cache_constructor(circuit *circuit, input_value *input_value, output_value *output_value) {
+	size_t num_of_bits = input_value->original_num_of_inputs;
+	size_t num_of_blocks = input_value->num_of_blocks;
+	size_t num_of_signals = input_value->num_of_signals;
+	size_t num_of_block_words = input_value->num_of_block_words;
+	size_t num_of_padded_words = num_of_blocks * num_of_block_words;
+	size_t num_of_block_signal_words = num_of_signals * num_of_block_words;
+	signal_cache *new_signal_cache = malloc(sizeof(signal_cache));
+	new_signal_cache->values = malloc(sizeof(uint64_t) * num_of_blocks * num_of_block_signal_words);
+	for (size_t b = 0; b < num_of_blocks; b++) {
+		uint64_t *block_values = new_signal_cache->values + b * num_of_block_signal_words;
+		memcpy(block_values, input_value->signal_values, sizeof(uint64_t) * num_of_block_signal_words);
+		for (size_t i = 0; i < num_of_bits; i++) {
+			uint64_t *words = input_value->input_words + i * num_of_padded_words + b * num_of_block_words;
+			memcpy(block_values + i * num_of_block_words, words, sizeof(uint64_t) * num_of_block_words);
+		}
+	}
+	new_signal_cache->block_types = malloc(sizeof(gate_type) * num_of_blocks * circuit->num_of_other_gates);
+	new_signal_cache->first_stale_gates = calloc(num_of_blocks, sizeof(size_t));
+	new_signal_cache->is_gate_dirty = calloc(circuit->num_of_gates, sizeof(bool));
+	new_signal_cache->is_signal_dirty = calloc(num_of_signals, sizeof(bool));
+	new_signal_cache->other_gate_indices = circuit->other_gate_indices;
+	new_signal_cache->other_gate_positions = malloc(sizeof(size_t) * (circuit->num_of_other_gates + 1));
+	for (size_t z = 0; z < circuit->num_of_other_gates; z++) {
+		new_signal_cache->other_gate_positions[z] = circuit->compiled_netlist->positions[circuit->other_gate_indices[z]];
+	}
+	new_signal_cache->compiled_netlist = circuit->compiled_netlist;
+	// a primary output is republished from the plane its last driver writes, not from its own signal, and
+	// one that no gate drives is left at 0 even when it names a primary input or a constant
+	size_t *signal_ids = malloc(sizeof(size_t) * (output_value->num_of_outputs + 1));
+	size_t *signal_planes = malloc(sizeof(size_t) * (circuit->signals->num_of_signals + 1));
+	for (size_t i = 0; i < circuit->signals->num_of_signals; i++) {
+		signal_planes[i] = SIZE_MAX;
+	}
+	for (size_t i = 0; i < output_value->num_of_outputs; i++) {
+		char *name = output_value->outputs[i]->output;
+		signal_ids[i] = signal_table_find(circuit->signals, name, strlen(name));
+	}
+	for (size_t p = 0; p < circuit->compiled_netlist->num_of_pins; p++) {
+		size_t slot = circuit->compiled_netlist->output_slots[p];
+		if (slot != NO_OUTPUT_SLOT) {
+			signal_planes[signal_ids[slot]] = circuit->compiled_netlist->pins[p];
+		}
+	}
+	new_signal_cache->output_signal_ids = malloc(sizeof(size_t) * output_value->num_of_outputs);
+	for (size_t i = 0; i < output_value->num_of_outputs; i++) {
+		new_signal_cache->output_signal_ids[i] = (signal_ids[i] != SIZE_MAX) ? signal_planes[signal_ids[i]] : SIZE_MAX;
+	}
+	signal_ids = Free(signal_ids);
+	signal_planes = Free(signal_planes);
+	new_signal_cache->num_of_blocks = num_of_blocks;
+	new_signal_cache->num_of_signals = num_of_signals;
+	new_signal_cache->num_of_block_words = num_of_block_words;
+	new_signal_cache->num_of_gates = circuit->num_of_gates;
+	new_signal_cache->num_of_other_gates = circuit->num_of_other_gates;
+	new_signal_cache->num_of_outputs = output_value->num_of_outputs;
+	return new_signal_cache;
+}
+
+signal_cache* signal_cache_free(signal_cache *signal_cache, bool keep_outer) {
+	if (signal_cache == NULL) {
+		return NULL;
+	}
+	signal_cache->values = Free(signal_cache->values);
+	signal_cache->block_types = Free(signal_cache->block_types);
+	signal_cache->first_stale_gates = Free(signal_cache->first_stale_gates);
+	signal_cache->is_gate_dirty = Free(signal_cache->is_gate_dirty);
+	signal_cache->is_signal_dirty = Free(signal_cache->is_signal_dirty);
+	signal_cache->output_signal_ids = Free(signal_cache->output_signal_ids);
+	signal_cache->other_gate_positions = Free(signal_cache->other_gate_positions);
+	signal_cache->other_gate_indices = NULL;
+	signal_cache->compiled_netlist = NULL;
+	if (!keep_outer) {
+		signal_cache = Free(signal_cache);
+		return NULL;
+	}
+	signal_cache->num_of_blocks = 0;
+	signal_cache->num_of_signals = 0;
+	signal_cache->num_of_block_words = 0;
+	signal_cache->num_of_gates = 0;
+	signal_cache->num_of_other_gates = 0;
+	signal_cache->num_of_outputs = 0;
+	return NULL;
+}
+
+// Brings one block of the cache up to date with the current gate types. Only the unknown gates whose
+// type differs from the one the block was last simulated with, the gates they feed, and any gates left
+// stale by an earlier early exit are evaluated; every other plane is reused.
+bool evaluate_block_incrementally(gate **gates, bytecode *bytecode, signal_cache *signal_cache, input_value *input_value, output_value *output_value, size_t index_of_block) {
+	size_t num_of_gates = signal_cache->num_of_gates;
+	size_t num_of_other_gates = signal_cache->num_of_other_gates;
+	size_t num_of_block_words = signal_cache->num_of_block_words;
+	size_t num_of_block_signal_words = signal_cache->num_of_signals * num_of_block_words;
+	gate_type *block_types = signal_cache->block_types + index_of_block * num_of_other_gates;
+	size_t first_stale_gate = signal_cache->first_stale_gates[index_of_block];
+	size_t first_gate = first_stale_gate;
+	compiled_netlist *compiled_netlist = signal_cache->compiled_netlist;
+	for (size_t z = 0; z < num_of_other_gates; z++) {
+		size_t index_of_gate = signal_cache->other_gate_indices[z];
+		size_t position = signal_cache->other_gate_positions[z];
+		if (position < first_stale_gate && block_types[z] != gates[index_of_gate]->type) {
+			signal_cache->is_gate_dirty[position] = true;
+			if (position < first_gate) {
+				first_gate = position;
+			}
+		}
+		block_types[z] = gates[index_of_gate]->type;
+	}
+	uint64_t *signal_values = input_value->signal_values;
+	input_value->signal_values = signal_cache->values + index_of_block * num_of_block_signal_words;
+	input_value->num_of_active_words = num_of_block_words;
+	bool is_success = true;
+	signal_cache->first_stale_gates[index_of_block] = num_of_gates;
+	for (size_t k = first_gate; k < num_of_gates; k++) {
+		compiled_gate IO = get_compiled_gate(compiled_netlist, k);
+		bool is_dirty = k >= first_stale_gate || signal_cache->is_gate_dirty[k] || signal_is_dirty(signal_cache->is_signal_dirty, IO.input_ids, IO.num_of_inputs) || signal_is_dirty(signal_cache->is_signal_dirty, IO.selector_ids, IO.num_of_selectors);
+		signal_cache->is_gate_dirty[k] = false;
+		if (!is_dirty) {
+			continue;
+		}
+		if (!run_bytecode(bytecode->code + bytecode->instruction_offsets[k], 1, input_value, output_value, index_of_block)) {
+			signal_cache->first_stale_gates[index_of_block] = k;
+			is_success = false;
+			break;
+		}
+		for (size_t i = 0; i < IO.num_of_outputs; i++) {
+			signal_cache->is_signal_dirty[IO.output_ids[i]] = true;
+		}
+	}
+	for (size_t z = 0; z < num_of_other_gates; z++) {
+		signal_cache->is_gate_dirty[signal_cache->other_gate_positions[z]] = false;
+	}
+	memset(signal_cache->is_signal_dirty, 0, sizeof(bool) * signal_cache->num_of_signals);
+	for (size_t i = 0; i < signal_cache->num_of_outputs && is_success; i++) {
+		size_t signal_id = signal_cache->output_signal_ids[i];
+		if (signal_id != SIZE_MAX) {
+			uint64_t *plane = get_plane_of_signal(signal_id, input_value);
+			memcpy(output_value->gen_outputs[i]->words + index_of_block * num_of_block_words, plane, sizeof(uint64_t) * num_of_block_words);
+		}
+		is_success = final_output_block_matches(output_value, i, index_of_block);
+	}
+	input_value->signal_values = signal_values;
+	return is_success;
+}
+
+bool evaluate_candidate(gate **gates, bytecode *bytecode, signal_cache *signal_cache, input_value *input_value, output_value *output_value) {
+	size_t num_of_blocks = input_value->num_of_blocks;
+	bool is_success = true;
+	bytecode_load_types(bytecode, gates);
+	if (output_value->num_of_probe_rows > 0) {
+		is_success = evaluate_gates(bytecode, input_value, output_value, PROBE_BLOCK);
+	}
+	for (size_t j = 0; j < num_of_blocks && is_success; j++) {
+		if (signal_cache != NULL) {
+			is_success = evaluate_block_incrementally(gates, bytecode, signal_cache, input_value, output_value, j);
+		} else {
+			is_success = evaluate_gates(bytecode, input_value, output_value, j);
+		}
+	}
+	if (!is_success) {
+		add_killer_row(input_value, output_value);
+		reset_output_value(output_value);
+		return false;
+	}
+	if (!gen_outputs_correct(output_value)) {
+		reset_output_value(output_value);
+		return false;
+	}
+	return true;
+}
+
+input_value* input_value_clone(input_value *source) {
+	input_value *input_value = input_value_constructor();
+	size_t num_of_bits = source->original_num_of_inputs;
+	size_t num_of_block_words = source->num_of_block_words;
+	input_value->original_num_of_inputs = num_of_bits;
+	input_value->num_of_inputs = source->num_of_inputs;
+	input_value->inputs = malloc(sizeof(input*) * source->num_of_inputs);
+	for (size_t i = 0; i < source->num_of_inputs; i++) {
+		input_value->inputs[i] = input_constructor();
+		input_value->inputs[i]->input = malloc(sizeof(char) * (strlen(source->inputs[i]->input) + 1));
+		strcpy(input_value->inputs[i]->input, source->inputs[i]->input);
+		input_value->inputs[i]->value = source->inputs[i]->value;
+	}
+	input_value->num_of_signals = source->num_of_signals;
+	input_value->num_of_blocks = source->num_of_blocks;
+	input_value->num_of_block_words = num_of_block_words;
+	input_value->input_words = source->input_words;
+	input_value->signal_values = malloc(sizeof(uint64_t) * source->num_of_signals * num_of_block_words);
+	memcpy(input_value->signal_values, source->signal_values, sizeof(uint64_t) * source->num_of_signals * num_of_block_words);
+	input_value->scratch_planes = calloc(MAX_NUM_OF_SELECT_BITS * num_of_block_words, sizeof(uint64_t));
+	input_value->probe_words = calloc(num_of_bits, sizeof(uint64_t));
+	input_value->is_signal_dirty = calloc(source->num_of_signals, sizeof(bool));
+	input_value->first = source->first;
+	return input_value;
+}
+
+output_value* output_value_clone(output_value *source) {
+	output_value *output_value = output_value_constructor();
+	size_t num_of_outputs = source->num_of_outputs;
+	output_value_allocate_outputs(output_value, num_of_outputs);
+	output_value->num_of_block_words = source->num_of_block_words;
+	for (size_t i = 0; i < num_of_outputs; i++) {
+		output *expected = source->outputs[i];
+		size_t num_of_padded_words = get_num_of_padded_words(expected->num_of_values);
+		for (size_t j = 0; j < 2; j++) {
+			output *output = (j == 0) ? output_value->outputs[i] : output_value->gen_outputs[i];
+			output->output = malloc(sizeof(char) * (strlen(expected->output) + 1));
+			strcpy(output->output, expected->output);
+			output->num_of_values = expected->num_of_values;
+			output->num_of_words = expected->num_of_words;
+			output->words = calloc(num_of_padded_words, sizeof(uint64_t));
+		}
+		memcpy(output_value->outputs[i]->words, expected->words, sizeof(uint64_t) * num_of_padded_words);
+	}
+	output_value->probe_words = calloc(num_of_outputs, sizeof(uint64_t));
+	output_value->probe_rows = malloc(sizeof(size_t) * MAX_NUM_OF_PROBE_ROWS);
+	return output_value;
+}
+
+search_worker* search_worker_constructor(search_pool *pool, input_value *input_value, output_value *output_value) {
+	circuit *circuit = pool->circuit;
+	size_t num_of_gates = circuit->num_of_gates;
+	search_worker *new_search_worker = malloc(sizeof(search_worker));
+	new_search_worker->pool = pool;
+	new_search_worker->gates = malloc(sizeof(gate*) * num_of_gates);
+	for (size_t i = 0; i < num_of_gates; i++) {
+		new_search_worker->gates[i] = malloc(sizeof(gate));
+		new_search_worker->gates[i]->type = circuit->gates[i]->type;
+		new_search_worker->gates[i]->input_output = circuit->gates[i]->input_output;
+	}
+	new_search_worker->bytecode = bytecode_clone(circuit->bytecode);
+	new_search_worker->assignment_iterator = assignment_iterator_constructor(new_search_worker->gates, circuit);
+	new_search_worker->input_value = input_value_clone(input_value);
+	new_search_worker->output_value = output_value_clone(output_value);
+	new_search_worker->signal_cache = NULL;
+	if (circuit->jit_program == NULL && signal_cache_fits(input_value, pool->num_of_workers)) {
+		new_search_worker->signal_cache = signal_cache_constructor(circuit, new_search_worker->input_value, new_search_worker->output_value);
+	}
+	new_search_worker->chunks = malloc(sizeof(size_t) * (pool->num_of_chunks / pool->num_of_workers + 1));
+	new_search_worker->head = 0;
+	new_search_worker->tail = 0;
+	pthread_mutex_init(&new_search_worker->lock, NULL);
+	return new_search_worker;
+}
+
+search_pool* search_pool_constructor(circuit *circuit, input_value *input_value, output_value *output_value, size_t num_of_workers, size_t num_of_candidates) {
+	search_pool *new_search_pool = malloc(sizeof(search_pool));
+	new_search_pool->circuit = circuit;
+	new_search_pool->num_of_workers = num_of_workers;
+	new_search_pool->num_of_candidates = num_of_candidates;
+	new_search_pool->chunk_size = num_of_candidates / (num_of_workers * SEARCH_CHUNKS_PER_WORKER);
+	if (new_search_pool->chunk_size == 0) {
+		new_search_pool->chunk_size = 1;
+	}
+	new_search_pool->num_of_chunks = (num_of_candidates + new_search_pool->chunk_size - 1) / new_search_pool->chunk_size;
+	atomic_init(&new_search_pool->best_candidate, SIZE_MAX);
+	new_search_pool->workers = malloc(sizeof(search_worker*) * num_of_workers);
+	for (size_t i = 0; i < num_of_workers; i++) {
+		new_search_pool->workers[i] = search_worker_constructor(new_search_pool, input_value, output_value);
+	}
+	for (size_t i = 0; i < new_search_pool->num_of_chunks; i++) {
+		search_worker *worker = new_search_pool->workers[i % num_of_workers];
+		worker->chunks[worker->tail] = i;
+		worker->tail++;
+	}
+	return new_search_pool;
+}
+
+search_worker* search_worker_free(search_worker *search_worker, bool keep_outer) {
+	if (search_worker == NULL) {
+		return NULL;
+	}
+	size_t num_of_gates = search_worker->pool->circuit->num_of_gates;
 	for (size_t i = 0; i < num_of_gates; i++) {
-		if (circuit->gates[i]->type == OTHER) {
-			circuit->other_gate_indices[curr_index] = i;
-			curr_index++;
-		}
+		search_worker->gates[i] = Free(search_worker->gates[i]);
+	}
+	search_worker->gates = Free(search_worker->gates);
+	search_worker->bytecode->instruction_offsets = NULL;
+	search_worker->bytecode->other_gate_offsets = NULL;
+	search_worker->bytecode->other_gate_opcodes = NULL;
+	search_worker->bytecode = bytecode_free(search_worker->bytecode, false);
+	search_worker->assignment_iterator = assignment_iterator_free(search_worker->assignment_iterator, false);
+	search_worker->input_value->input_words = NULL;
+	search_worker->input_value = input_value_free(search_worker->input_value, false);
+	search_worker->output_value = output_value_free(search_worker->output_value, false);
+	search_worker->signal_cache = signal_cache_free(search_worker->signal_cache, false);
+	search_worker->chunks = Free(search_worker->chunks);
+	pthread_mutex_destroy(&search_worker->lock);
+	if (!keep_outer) {
+		search_worker = Free(search_worker);
+		return NULL;
 	}
-	gen_other_gate_permutations(circuit);
-	return circuit;
+	search_worker->head = 0;
+	search_worker->tail = 0;
+	return NULL;
 }
 
-void reset_input_value(input_value *input_value, size_t input_vars_permutation) {
-	size_t ONE = 1;
-	size_t num_of_bits = input_value->original_num_of_inputs;
-	size_t curr_num_of_inputs = input_value->current_num_of_inputs;
-	for (size_t i = num_of_bits + 2; i < curr_num_of_inputs; i++) {
-		input_free(input_value->inputs[i], true);
+search_pool* search_pool_free(search_pool *search_pool, bool keep_outer) {
+	if (search_pool == NULL) {
+		return NULL;
 	}
-	size_t bit_counter = num_of_bits - ONE;
-	input_value->current_num_of_inputs = num_of_bits + 2;
-	for (size_t i = 0; i < num_of_bits; i++) {
-		input_value->inputs[i]->value = (input_vars_permutation & (ONE << bit_counter)) >> bit_counter;
-		bit_counter--;
+	size_t num_of_workers = search_pool->num_of_workers;
+	for (size_t i = 0; i < num_of_workers; i++) {
+		search_pool->workers[i] = search_worker_free(search_pool->workers[i], false);
+	}
+	search_pool->workers = Free(search_pool->workers);
+	if (!keep_outer) {
+		search_pool = Free(search_pool);
+		return NULL;
 	}
+	search_pool->num_of_workers = 0;
+	search_pool->num_of_candidates = 0;
+	search_pool->num_of_chunks = 0;
+	search_pool->chunk_size = 0;
+	return NULL;
 }
 
-void reset_output_value(output_value *output_value) {
-	size_t num_of_outputs = output_value->num_of_outputs;
-	for (size_t i = 0; i < num_of_outputs; i++) {
-		size_t num_of_values = output_value->gen_outputs[i]->num_of_values;
-		for (size_t j = 0; j < num_of_values; j++) {
-			output_value->gen_outputs[i]->values[j] = 0;
+bool search_worker_pop(search_worker *search_worker, size_t *chunk) {
+	bool is_success = false;
+	pthread_mutex_lock(&search_worker->lock);
+	if (search_worker->head < search_worker->tail) {
+		*chunk = search_worker->chunks[search_worker->head];
+		search_worker->head++;
+		is_success = true;
+	}
+	pthread_mutex_unlock(&search_worker->lock);
+	return is_success;
+}
+
+bool search_worker_steal(search_worker *search_worker, size_t *chunk) {
+	bool is_success = false;
+	pthread_mutex_lock(&search_worker->lock);
+	if (search_worker->head < search_worker->tail) {
+		search_worker->tail--;
+		*chunk = search_worker->chunks[search_worker->tail];
+		is_success = true;
+	}
+	pthread_mutex_unlock(&search_worker->lock);
+	return is_success;
+}
+
+bool search_pool_next_chunk(search_pool *search_pool, search_worker *search_worker, size_t *chunk) {
+	if (search_worker_pop(search_worker, chunk)) {
+		return true;
+	}
+	size_t num_of_workers = search_pool->num_of_workers;
+	size_t index_of_worker = 0;
+	while (search_pool->workers[index_of_worker] != search_worker) {
+		index_of_worker++;
+	}
+	for (size_t i = 1; i < num_of_workers; i++) {
+		if (search_worker_steal(search_pool->workers[(index_of_worker + i) % num_of_workers], chunk)) {
+			return true;
 		}
 	}
+	return false;
 }
 
-bool gen_outputs_correct(output_value *output_value) {
-	size_t num_of_outputs = output_value->num_of_outputs;
-	for (size_t i = 0; i < num_of_outputs; i++) {
-		size_t num_of_values = output_value->gen_outputs[i]->num_of_values;
-		for (size_t j = 0; j < num_of_values; j++) {
-			if (output_value->gen_outputs[i]->values[j] != output_value->outputs[i]->values[j]) {
-				return false;
+void search_pool_report(search_pool *search_pool, size_t candidate) {
+	size_t best_candidate = atomic_load(&search_pool->best_candidate);
+	while (candidate < best_candidate && !atomic_compare_exchange_weak(&search_pool->best_candidate, &best_candidate, candidate)) {
+	}
+}
+
+void* search_worker_run(void *argument) {
+	search_worker *search_worker = argument;
+	search_pool *search_pool = search_worker->pool;
+	assignment_iterator *assignment_iterator = search_worker->assignment_iterator;
+	size_t chunk = 0;
+	while (search_pool_next_chunk(search_pool, search_worker, &chunk)) {
+		size_t first_candidate = chunk * search_pool->chunk_size;
+		size_t last_candidate = first_candidate + search_pool->chunk_size;
+		if (last_candidate > search_pool->num_of_candidates) {
+			last_candidate = search_pool->num_of_candidates;
+		}
+		assignment_iterator_seek(assignment_iterator, first_candidate, last_candidate);
+		do {
+			if (assignment_iterator->candidate >= atomic_load(&search_pool->best_candidate)) {
+				break;
+			}
+			if (evaluate_candidate(search_worker->gates, search_worker->bytecode, search_worker->signal_cache, search_worker->input_value, search_worker->output_value)) {
+				search_pool_report(search_pool, assignment_iterator->candidate);
+				break;
 			}
+		} while (assignment_iterator_next(assignment_iterator));
+	}
+	return NULL;
+}
+
+// One worker per online CPU unless $CIRCUIT_SEARCH_WORKERS asks for another count. Every worker clones the
+// evaluation state, so the count is capped at MAX_NUM_OF_SEARCH_WORKERS and at one per
+// MIN_CANDIDATES_PER_WORKER candidates.
+size_t get_num_of_search_workers(size_t num_of_candidates) {
+	long num_of_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	size_t num_of_workers = (num_of_cpus > 0) ? (size_t) num_of_cpus : 1;
+	const char *requested = getenv("CIRCUIT_SEARCH_WORKERS");
+	if (requested != NULL && strtoul(requested, NULL, 10) > 0) {
+		num_of_workers = strtoul(requested, NULL, 10);
+	}
+	if (num_of_workers > MAX_NUM_OF_SEARCH_WORKERS) {
+		num_of_workers = MAX_NUM_OF_SEARCH_WORKERS;
+	}
+	if (num_of_workers > num_of_candidates / MIN_CANDIDATES_PER_WORKER) {
+		num_of_workers = num_of_candidates / MIN_CANDIDATES_PER_WORKER;
+	}
+	return num_of_workers;
+}
+
+// A worker whose thread cannot be created leaves its chunks to be stolen by the others; the calling
+// thread runs the first such worker itself, so the search completes even when no thread starts at all.
+bool parallel_search(circuit *circuit, input_value *input_value, output_value *output_value, size_t num_of_workers, size_t num_of_candidates) {
+	search_pool *search_pool = search_pool_constructor(circuit, input_value, output_value, num_of_workers, num_of_candidates);
+	bool *is_started = calloc(num_of_workers, sizeof(bool));
+	search_worker *unstarted_worker = NULL;
+	for (size_t i = 0; i < num_of_workers; i++) {
+		is_started[i] = pthread_create(&search_pool->workers[i]->thread, NULL, search_worker_run, search_pool->workers[i]) == 0;
+		if (!is_started[i] && unstarted_worker == NULL) {
+			unstarted_worker = search_pool->workers[i];
+		}
+	}
+	if (unstarted_worker != NULL) {
+		search_worker_run(unstarted_worker);
+	}
+	for (size_t i = 0; i < num_of_workers; i++) {
+		if (is_started[i]) {
+			pthread_join(search_pool->workers[i]->thread, NULL);
 		}
 	}
+	is_started = Free(is_started);
+	size_t best_candidate = atomic_load(&search_pool->best_candidate);
+	search_pool = search_pool_free(search_pool, false);
+	if (best_candidate == SIZE_MAX) {
+		return false;
+	}
+	assignment_iterator *assignment_iterator = assignment_iterator_constructor(circuit->gates, circuit);
+	assignment_iterator_seek(assignment_iterator, best_candidate, best_candidate + 1);
+	assignment_iterator = assignment_iterator_free(assignment_iterator, false);
 	return true;
 }
 
-size_t get_value_of_input_var(char *input_var, input_value *input_value) {
-	size_t num_of_inputs = input_value->current_num_of_inputs;
-	for (size_t i = 0; i < num_of_inputs; i++) {
-		if (strcmp(input_value->inputs[i]->input, input_var) == 0) {
-			return input_value->inputs[i]->value;
+bool sequential_search(circuit *circuit, input_value *input_value, output_value *output_value, size_t num_of_candidates) {
+	bool correct_output = false;
+	if (num_of_candidates == 0) {
+		return correct_output;
+	}
+	assignment_iterator *assignment_iterator = assignment_iterator_constructor(circuit->gates, circuit);
+	signal_cache *signal_cache = NULL;
+	// native code evaluates whole blocks, so a compiled netlist runs every block of a candidate through it
+	if (num_of_candidates > 1 && circuit->jit_program == NULL && signal_cache_fits(input_value, 1)) {
+		signal_cache = signal_cache_constructor(circuit, input_value, output_value);
+	}
+	assignment_iterator_seek(assignment_iterator, 0, num_of_candidates);
+	do {
+		if (evaluate_candidate(circuit->gates, circuit->bytecode, signal_cache, input_value, output_value)) {
+			correct_output = true;
+			break;
 		}
+	} while (assignment_iterator_next(assignment_iterator));
+	assignment_iterator = assignment_iterator_free(assignment_iterator, false);
+	signal_cache = signal_cache_free(signal_cache, false);
+	return correct_output;
+}
+
+size_t sat_literal(size_t var, bool is_negated) {
+	return var * 2 + (is_negated ? 1 : 0);
+}
+
+uint8_t sat_literal_value(sat_solver *sat_solver, size_t literal) {
+	uint8_t value = sat_solver->values[literal >> 1];
+	if (value == SAT_UNASSIGNED) {
+		return SAT_UNASSIGNED;
 	}
-	return 0;
+	return value ^ (uint8_t) (literal & 1);
 }
 
-bool output_var_is_final(char *output_var, output_value *output_value) {
-	size_t num_of_outputs = output_value->num_of_outputs;
-	for (size_t i = 0; i < num_of_outputs; i++) {
-		if (strcmp(output_value->outputs[i]->output, output_var) == 0) {
-			return true;
+void sat_heap_swap(sat_solver *sat_solver, size_t i, size_t j) {
+	size_t var_i = sat_solver->heap[i];
+	size_t var_j = sat_solver->heap[j];
+	sat_solver->heap[i] = var_j;
+	sat_solver->heap[j] = var_i;
+	sat_solver->heap_positions[var_j] = i;
+	sat_solver->heap_positions[var_i] = j;
+}
+
+void sat_heap_percolate_up(sat_solver *sat_solver, size_t position) {
+	while (position > 0) {
+		size_t parent = (position - 1) / 2;
+		if (sat_solver->activities[sat_solver->heap[parent]] >= sat_solver->activities[sat_solver->heap[position]]) {
+			break;
 		}
+		sat_heap_swap(sat_solver, parent, position);
+		position = parent;
 	}
-	return false;
 }
 
-void update_final_output_var(char *final_output_var, size_t value, size_t index_of_current_input_permutation, output_value *output_value) {
-	size_t num_of_outputs = output_value->num_of_outputs;
-	for (size_t i = 0; i < num_of_outputs; i++) {
-		if (strcmp(output_value->gen_outputs[i]->output, final_output_var) == 0) {
-			output_value->gen_outputs[i]->values[index_of_current_input_permutation] = value;
+void sat_heap_percolate_down(sat_solver *sat_solver, size_t position) {
+	while (true) {
+		size_t largest = position;
+		size_t left = position * 2 + 1;
+		size_t right = left + 1;
+		if (left < sat_solver->heap_size && sat_solver->activities[sat_solver->heap[left]] > sat_solver->activities[sat_solver->heap[largest]]) {
+			largest = left;
+		}
+		if (right < sat_solver->heap_size && sat_solver->activities[sat_solver->heap[right]] > sat_solver->activities[sat_solver->heap[largest]]) {
+			largest = right;
+		}
+		if (largest == position) {
 			return;
 		}
+		sat_heap_swap(sat_solver, largest, position);
+		position = largest;
 	}
-	return;
 }
 
-void add_output_to_inputs(char *output_var, size_t value, input_value *input_value) {
-	size_t curr_num_of_inputs = input_value->current_num_of_inputs;
-	input_value->current_num_of_inputs++;
-	input_value->inputs[curr_num_of_inputs]->input = malloc(sizeof(char) * (strlen(output_var) + 1));
-	strcpy(input_value->inputs[curr_num_of_inputs]->input, output_var);
-	input_value->inputs[curr_num_of_inputs]->value = value;
+void sat_heap_insert(sat_solver *sat_solver, size_t var) {
+	if (sat_solver->heap_positions[var] != SIZE_MAX) {
+		return;
+	}
+	sat_solver->heap[sat_solver->heap_size] = var;
+	sat_solver->heap_positions[var] = sat_solver->heap_size;
+	sat_solver->heap_size++;
+	sat_heap_percolate_up(sat_solver, sat_solver->heap_size - 1);
 }
 
-bool increment_other_gate_return_skip(circuit *circuit, size_t index_of_other_gate_permutation) {
-	gate *gate = circuit->gates[circuit->other_gate_indices[circuit->other_gate_permutations[index_of_other_gate_permutation]]];
-	if (gate->type == MULTIPLEXER) {
-		gate->type = OR;
-		return true;
+size_t sat_heap_pop(sat_solver *sat_solver) {
+	size_t var = sat_solver->heap[0];
+	sat_solver->heap_size--;
+	if (sat_solver->heap_size > 0) {
+		sat_heap_swap(sat_solver, 0, sat_solver->heap_size);
 	}
-	gate->type = gate->type + 1;
-	return false;
+	sat_solver->heap_positions[var] = SIZE_MAX;
+	sat_heap_percolate_down(sat_solver, 0);
+	return var;
 }
 
-size_t get_number_of_selectors(size_t num_of_inputs) {
-	size_t ONE = 1;
-	size_t result = ONE;
-	if (num_of_inputs < 3) {
-		return 0;
+size_t sat_solver_new_var(sat_solver *sat_solver) {
+	size_t var = sat_solver->num_of_vars;
+	if (var == sat_solver->max_num_of_vars) {
+		size_t max_num_of_vars = (var == 0) ? 64 : var * 2;
+		sat_solver->values = realloc(sat_solver->values, sizeof(uint8_t) * max_num_of_vars);
+		sat_solver->phases = realloc(sat_solver->phases, sizeof(uint8_t) * max_num_of_vars);
+		sat_solver->model = realloc(sat_solver->model, sizeof(uint8_t) * max_num_of_vars);
+		sat_solver->seen = realloc(sat_solver->seen, sizeof(bool) * max_num_of_vars);
+		sat_solver->levels = realloc(sat_solver->levels, sizeof(size_t) * max_num_of_vars);
+		sat_solver->reasons = realloc(sat_solver->reasons, sizeof(size_t) * max_num_of_vars);
+		sat_solver->trail = realloc(sat_solver->trail, sizeof(size_t) * max_num_of_vars);
+		sat_solver->trail_limits = realloc(sat_solver->trail_limits, sizeof(size_t) * (max_num_of_vars + 1));
+		sat_solver->learnt = realloc(sat_solver->learnt, sizeof(size_t) * (max_num_of_vars + 1));
+		sat_solver->activities = realloc(sat_solver->activities, sizeof(double) * max_num_of_vars);
+		sat_solver->heap = realloc(sat_solver->heap, sizeof(size_t) * max_num_of_vars);
+		sat_solver->heap_positions = realloc(sat_solver->heap_positions, sizeof(size_t) * max_num_of_vars);
+		sat_solver->watches = realloc(sat_solver->watches, sizeof(size_t*) * max_num_of_vars * 2);
+		sat_solver->num_of_watches = realloc(sat_solver->num_of_watches, sizeof(size_t) * max_num_of_vars * 2);
+		sat_solver->max_num_of_watches = realloc(sat_solver->max_num_of_watches, sizeof(size_t) * max_num_of_vars * 2);
+		sat_solver->max_num_of_vars = max_num_of_vars;
 	}
-	while (((ONE << result) + result) < num_of_inputs) {
-		result++;
+	sat_solver->values[var] = SAT_UNASSIGNED;
+	sat_solver->phases[var] = 0;
+	sat_solver->model[var] = SAT_UNASSIGNED;
+	sat_solver->seen[var] = false;
+	sat_solver->levels[var] = 0;
+	sat_solver->reasons[var] = SAT_NO_REASON;
+	sat_solver->activities[var] = 0;
+	sat_solver->heap_positions[var] = SIZE_MAX;
+	for (size_t i = var * 2; i < var * 2 + 2; i++) {
+		sat_solver->watches[i] = NULL;
+		sat_solver->num_of_watches[i] = 0;
+		sat_solver->max_num_of_watches[i] = 0;
 	}
-	if (((ONE << result) + result) == num_of_inputs) {
-		return result;
+	sat_solver->num_of_vars++;
+	sat_heap_insert(sat_solver, var);
+	return var;
+}
+
+void sat_watch(sat_solver *sat_solver, size_t literal, size_t clause) {
+	if (sat_solver->num_of_watches[literal] == sat_solver->max_num_of_watches[literal]) {
+		size_t max_num_of_watches = (sat_solver->max_num_of_watches[literal] == 0) ? 4 : sat_solver->max_num_of_watches[literal] * 2;
+		sat_solver->watches[literal] = realloc(sat_solver->watches[literal], sizeof(size_t) * max_num_of_watches);
+		sat_solver->max_num_of_watches[literal] = max_num_of_watches;
 	}
-	return 0;
+	sat_solver->watches[literal][sat_solver->num_of_watches[literal]] = clause;
+	sat_solver->num_of_watches[literal]++;
 }
 
-bool OR_gate(input_output *IO, input_value *input_value, output_value *output_value, size_t index_of_input_permu) {
-	if (IO->num_of_inputs != 2 || IO->num_of_outputs != 1 || IO->num_of_selectors != 0) {
-		return false;
+void sat_reserve_literals(sat_solver *sat_solver, size_t num_of_literals) {
+	if (sat_solver->num_of_literals + num_of_literals <= sat_solver->max_num_of_literals) {
+		return;
 	}
-	size_t input_1 = get_value_of_input_var(IO->inputs[0], input_value);
-	size_t input_2 = get_value_of_input_var(IO->inputs[1], input_value);
-	size_t result = input_1 | input_2;
-	if (output_var_is_final(IO->outputs[0], output_value)) {
-		update_final_output_var(IO->outputs[0], result, index_of_input_permu, output_value);
-	} else {
-		add_output_to_inputs(IO->outputs[0], result, input_value);
+	size_t max_num_of_literals = (sat_solver->max_num_of_literals == 0) ? 1024 : sat_solver->max_num_of_literals;
+	while (max_num_of_literals < sat_solver->num_of_literals + num_of_literals) {
+		max_num_of_literals *= 2;
 	}
-	return true;
+	sat_solver->literals = realloc(sat_solver->literals, sizeof(size_t) * max_num_of_literals);
+	sat_solver->max_num_of_literals = max_num_of_literals;
 }
 
-bool AND_gate(input_output *IO, input_value *input_value, output_value *output_value, size_t index_of_input_permu) {
-	if (IO->num_of_inputs != 2 || IO->num_of_outputs != 1 || IO->num_of_selectors != 0) {
-		return false;
+// Stores the clause whose literals already sit at the end of the arena and watches its first two literals.
+size_t sat_store_clause(sat_solver *sat_solver, size_t num_of_literals) {
+	if (sat_solver->num_of_clauses == sat_solver->max_num_of_clauses) {
+		size_t max_num_of_clauses = (sat_solver->max_num_of_clauses == 0) ? 256 : sat_solver->max_num_of_clauses * 2;
+		sat_solver->clause_starts = realloc(sat_solver->clause_starts, sizeof(size_t) * max_num_of_clauses);
+		sat_solver->clause_sizes = realloc(sat_solver->clause_sizes, sizeof(size_t) * max_num_of_clauses);
+		sat_solver->max_num_of_clauses = max_num_of_clauses;
 	}
-	size_t input_1 = get_value_of_input_var(IO->inputs[0], input_value);
-	size_t input_2 = get_value_of_input_var(IO->inputs[1], input_value);
-	size_t result = input_1 & input_2;
-	if (output_var_is_final(IO->outputs[0], output_value)) {
-		update_final_output_var(IO->outputs[0], result, index_of_input_permu, output_value);
-	} else {
-		add_output_to_inputs(IO->outputs[0], result, input_value);
+	size_t clause = sat_solver->num_of_clauses;
+	size_t start = sat_solver->num_of_literals;
+	sat_solver->clause_starts[clause] = start;
+	sat_solver->clause_sizes[clause] = num_of_literals;
+	sat_solver->num_of_literals += num_of_literals;
+	sat_solver->num_of_clauses++;
+	sat_watch(sat_solver, sat_solver->literals[start], clause);
+	sat_watch(sat_solver, sat_solver->literals[start + 1], clause);
+	return clause;
+}
+
+void sat_enqueue(sat_solver *sat_solver, size_t literal, size_t reason) {
+	size_t var = literal >> 1;
+	sat_solver->values[var] = (uint8_t) ((literal & 1) ^ 1);
+	sat_solver->levels[var] = sat_solver->num_of_levels;
+	sat_solver->reasons[var] = reason;
+	sat_solver->trail[sat_solver->trail_size] = literal;
+	sat_solver->trail_size++;
+}
+
+size_t sat_propagate(sat_solver *sat_solver) {
+	while (sat_solver->propagation_head < sat_solver->trail_size) {
+		size_t false_literal = sat_solver->trail[sat_solver->propagation_head] ^ 1;
+		sat_solver->propagation_head++;
+		size_t *watches = sat_solver->watches[false_literal];
+		size_t num_of_watches = sat_solver->num_of_watches[false_literal];
+		size_t j = 0;
+		for (size_t i = 0; i < num_of_watches; i++) {
+			size_t clause = watches[i];
+			size_t *literals = sat_solver->literals + sat_solver->clause_starts[clause];
+			size_t num_of_literals = sat_solver->clause_sizes[clause];
+			if (literals[0] == false_literal) {
+				literals[0] = literals[1];
+				literals[1] = false_literal;
+			}
+			if (sat_literal_value(sat_solver, literals[0]) == 1) {
+				watches[j] = clause;
+				j++;
+				continue;
+			}
+			bool is_moved = false;
+			for (size_t k = 2; k < num_of_literals; k++) {
+				if (sat_literal_value(sat_solver, literals[k]) != 0) {
+					literals[1] = literals[k];
+					literals[k] = false_literal;
+					sat_watch(sat_solver, literals[1], clause);
+					is_moved = true;
+					break;
+				}
+			}
+			if (is_moved) {
+				continue;
+			}
+			watches[j] = clause;
+			j++;
+			if (sat_literal_value(sat_solver, literals[0]) == 0) {
+				for (i++; i < num_of_watches; i++) {
+					watches[j] = watches[i];
+					j++;
+				}
+				sat_solver->num_of_watches[false_literal] = j;
+				return clause;
+			}
+			sat_enqueue(sat_solver, literals[0], clause);
+		}
+		sat_solver->num_of_watches[false_literal] = j;
 	}
-	return true;
+	return SAT_NO_REASON;
 }
 
-bool XOR_gate(input_output *IO, input_value *input_value, output_value *output_value, size_t index_of_input_permu) {
-	if (IO->num_of_inputs != 2 || IO->num_of_outputs != 1 || IO->num_of_selectors != 0) {
-		return false;
+void sat_backtrack(sat_solver *sat_solver, size_t level) {
+	if (sat_solver->num_of_levels <= level) {
+		return;
 	}
-	size_t input_1 = get_value_of_input_var(IO->inputs[0], input_value);
-	size_t input_2 = get_value_of_input_var(IO->inputs[1], input_value);
-	size_t result = input_1 ^ input_2;
-	if (output_var_is_final(IO->outputs[0], output_value)) {
-		update_final_output_var(IO->outputs[0], result, index_of_input_permu, output_value);
-	} else {
-		add_output_to_inputs(IO->outputs[0], result, input_value);
+	size_t trail_limit = sat_solver->trail_limits[level];
+	for (size_t i = sat_solver->trail_size; i > trail_limit; i--) {
+		size_t var = sat_solver->trail[i - 1] >> 1;
+		sat_solver->phases[var] = sat_solver->values[var];
+		sat_solver->values[var] = SAT_UNASSIGNED;
+		sat_solver->reasons[var] = SAT_NO_REASON;
+		sat_heap_insert(sat_solver, var);
 	}
-	return true;
+	sat_solver->trail_size = trail_limit;
+	sat_solver->propagation_head = trail_limit;
+	sat_solver->num_of_levels = level;
 }
 
-bool NOT_gate(input_output *IO, input_value *input_value, output_value *output_value, size_t index_of_input_permu) {
-	if (IO->num_of_inputs != 1 || IO->num_of_outputs != 1 || IO->num_of_selectors != 0) {
-		return false;
+void sat_bump_var(sat_solver *sat_solver, size_t var) {
+	sat_solver->activities[var] += sat_solver->activity_increment;
+	if (sat_solver->activities[var] > 1e100) {
+		for (size_t i = 0; i < sat_solver->num_of_vars; i++) {
+			sat_solver->activities[i] *= 1e-100;
+		}
+		sat_solver->activity_increment *= 1e-100;
 	}
-	size_t input_1 = get_value_of_input_var(IO->inputs[0], input_value);
-	size_t result = !input_1;
-	if (output_var_is_final(IO->outputs[0], output_value)) {
-		update_final_output_var(IO->outputs[0], result, index_of_input_permu, output_value);
-	} else {
-		add_output_to_inputs(IO->outputs[0], result, input_value);
+	if (sat_solver->heap_positions[var] != SIZE_MAX) {
+		sat_heap_percolate_up(sat_solver, sat_solver->heap_positions[var]);
 	}
-	return true;
 }
 
-bool DECODER_gate(input_output *IO, input_value *input_value, output_value *output_value, size_t index_of_input_permu) {
+// First-UIP conflict analysis: leaves the learnt clause in sat_solver->learnt with the asserting literal
+// first and a literal of the backjump level second, and returns the number of literals.
+size_t sat_analyze(sat_solver *sat_solver, size_t conflict, size_t *backjump_level) {
+	size_t num_of_learnt = 1;
+	size_t num_of_paths = 0;
+	size_t literal = SAT_NO_REASON;
+	size_t index = sat_solver->trail_size;
+	size_t clause = conflict;
+	do {
+		size_t *literals = sat_solver->literals + sat_solver->clause_starts[clause];
+		size_t num_of_literals = sat_solver->clause_sizes[clause];
+		for (size_t j = (literal == SAT_NO_REASON) ? 0 : 1; j < num_of_literals; j++) {
+			size_t var = literals[j] >> 1;
+			if (sat_solver->seen[var] || sat_solver->levels[var] == 0) {
+				continue;
+			}
+			sat_bump_var(sat_solver, var);
+			sat_solver->seen[var] = true;
+			if (sat_solver->levels[var] >= sat_solver->num_of_levels) {
+				num_of_paths++;
+			} else {
+				sat_solver->learnt[num_of_learnt] = literals[j];
+				num_of_learnt++;
+			}
+		}
+		do {
+			index--;
+		} while (!sat_solver->seen[sat_solver->trail[index] >> 1]);
+		literal = sat_solver->trail[index];
+		clause = sat_solver->reasons[literal >> 1];
+		sat_solver->seen[literal >> 1] = false;
+		num_of_paths--;
+	} while (num_of_paths > 0);
+	sat_solver->learnt[0] = literal ^ 1;
+	*backjump_level = 0;
+	for (size_t i = 1; i < num_of_learnt; i++) {
+		size_t var = sat_solver->learnt[i] >> 1;
+		sat_solver->seen[var] = false;
+		if (sat_solver->levels[var] > *backjump_level) {
+			*backjump_level = sat_solver->levels[var];
+			size_t tmp = sat_solver->learnt[1];
+			sat_solver->learnt[1] = sat_solver->learnt[i];
+			sat_solver->learnt[i] = tmp;
+		}
+	}
+	return num_of_learnt;
+}
+
+size_t sat_luby(size_t index) {
 	size_t ONE = 1;
-	if (IO->num_of_inputs < 1 || IO->num_of_outputs != (ONE << IO->num_of_inputs) || IO->num_of_selectors != 0) {
-		return false;
+	size_t size = 1;
+	size_t sequence = 0;
+	while (size < index + 1) {
+		sequence++;
+		size = 2 * size + 1;
 	}
-	size_t num_of_bits = IO->num_of_inputs;
-	outcomes *outcomes = outcomes_builder(num_of_bits);
-	size_t num_of_outcomes = outcomes->num_of_outcomes;
-	for (size_t i = 0; i < num_of_outcomes; i++) {
-		size_t correct = 1;
-		size_t bit_counter = num_of_bits - ONE;
-		for (size_t j = 0; j < num_of_bits; j++) {
-			if (get_value_of_input_var(IO->inputs[j], input_value) != (outcomes->outcomes[i] & (ONE << bit_counter)) >> bit_counter) {
-				correct = 0;
-				break;
+	while (size - 1 != index) {
+		size = (size - 1) >> 1;
+		sequence--;
+		index = index % size;
+	}
+	return ONE << sequence;
+}
+
+// Adds a clause between solves. Literals fixed at level 0 are simplified away, so an empty
+// result makes the whole formula unsatisfiable and a unit one is assigned and propagated at once.
+void sat_add_clause(sat_solver *sat_solver, const size_t *literals, size_t num_of_literals) {
+	if (sat_solver->is_unsat) {
+		return;
+	}
+	sat_reserve_literals(sat_solver, num_of_literals);
+	size_t *kept = sat_solver->literals + sat_solver->num_of_literals;
+	size_t num_of_kept = 0;
+	for (size_t i = 0; i < num_of_literals; i++) {
+		uint8_t value = sat_literal_value(sat_solver, literals[i]);
+		if (value == 1) {
+			return;
+		}
+		if (value == 0) {
+			continue;
+		}
+		bool is_duplicate = false;
+		for (size_t j = 0; j < num_of_kept; j++) {
+			if (kept[j] == (literals[i] ^ 1)) {
+				return;
+			}
+			if (kept[j] == literals[i]) {
+				is_duplicate = true;
 			}
-			bit_counter--;
 		}
-		if (correct == 0) {
-			if (output_var_is_final(IO->outputs[i], output_value)) {
-				update_final_output_var(IO->outputs[i], 0, index_of_input_permu, output_value);
+		if (!is_duplicate) {
+			kept[num_of_kept] = literals[i];
+			num_of_kept++;
+		}
+	}
+	if (num_of_kept == 0) {
+		sat_solver->is_unsat = true;
+		return;
+	}
+	if (num_of_kept == 1) {
+		sat_enqueue(sat_solver, kept[0], SAT_NO_REASON);
+		if (sat_propagate(sat_solver) != SAT_NO_REASON) {
+			sat_solver->is_unsat = true;
+		}
+		return;
+	}
+	sat_store_clause(sat_solver, num_of_kept);
+}
+
+// CDCL search with the given literal as the first decision. Returns true with the satisfying assignment in
+// sat_solver->model, or false when the formula together with the assumption has no model.
+bool sat_solve(sat_solver *sat_solver, size_t assumption) {
+	if (sat_solver->is_unsat) {
+		return false;
+	}
+	size_t num_of_restarts = 0;
+	size_t num_of_conflicts = 0;
+	size_t conflict_limit = sat_luby(num_of_restarts) * SAT_RESTART_BASE;
+	while (true) {
+		size_t conflict = sat_propagate(sat_solver);
+		if (conflict != SAT_NO_REASON) {
+			if (sat_solver->num_of_levels == 0) {
+				sat_solver->is_unsat = true;
+				return false;
+			}
+			num_of_conflicts++;
+			size_t backjump_level = 0;
+			size_t num_of_learnt = sat_analyze(sat_solver, conflict, &backjump_level);
+			sat_backtrack(sat_solver, backjump_level);
+			if (num_of_learnt == 1) {
+				sat_enqueue(sat_solver, sat_solver->learnt[0], SAT_NO_REASON);
 			} else {
-				add_output_to_inputs(IO->outputs[i], 0, input_value);
+				sat_reserve_literals(sat_solver, num_of_learnt);
+				memcpy(sat_solver->literals + sat_solver->num_of_literals, sat_solver->learnt, sizeof(size_t) * num_of_learnt);
+				size_t clause = sat_store_clause(sat_solver, num_of_learnt);
+				sat_enqueue(sat_solver, sat_solver->learnt[0], clause);
 			}
+			sat_solver->activity_increment /= SAT_ACTIVITY_DECAY;
 			continue;
 		}
-		if (output_var_is_final(IO->outputs[i], output_value)) {
-			update_final_output_var(IO->outputs[i], 1, index_of_input_permu, output_value);
-		} else {
-			add_output_to_inputs(IO->outputs[i], 1, input_value);
+		if (num_of_conflicts >= conflict_limit) {
+			sat_backtrack(sat_solver, 0);
+			num_of_restarts++;
+			num_of_conflicts = 0;
+			conflict_limit = sat_luby(num_of_restarts) * SAT_RESTART_BASE;
+			continue;
+		}
+		if (assumption != SAT_NO_REASON && sat_solver->num_of_levels == 0) {
+			uint8_t value = sat_literal_value(sat_solver, assumption);
+			if (value == 0) {
+				return false;
+			}
+			sat_solver->trail_limits[sat_solver->num_of_levels] = sat_solver->trail_size;
+			sat_solver->num_of_levels++;
+			if (value == SAT_UNASSIGNED) {
+				sat_enqueue(sat_solver, assumption, SAT_NO_REASON);
+			}
+			continue;
+		}
+		size_t var = SAT_NO_REASON;
+		while (sat_solver->heap_size > 0) {
+			size_t candidate = sat_heap_pop(sat_solver);
+			if (sat_solver->values[candidate] == SAT_UNASSIGNED) {
+				var = candidate;
+				break;
+			}
+		}
+		if (var == SAT_NO_REASON) {
+			memcpy(sat_solver->model, sat_solver->values, sizeof(uint8_t) * sat_solver->num_of_vars);
+			sat_backtrack(sat_solver, 0);
+			return true;
 		}
+		sat_solver->trail_limits[sat_solver->num_of_levels] = sat_solver->trail_size;
+		sat_solver->num_of_levels++;
+		sat_enqueue(sat_solver, sat_literal(var, sat_solver->phases[var] != 1), SAT_NO_REASON);
 	}
-	outcomes = outcomes_free(outcomes, false);
-	return true;
 }
 
-bool MULTIPLEXER_gate(input_output *IO, input_value *input_value, output_value *output_value, size_t index_of_input_permu) {
+// Adds the clause with the type choice literal appended, so it only binds when that type is chosen.
+void sat_add_gate_clause(sat_solver *sat_solver, size_t *literals, size_t num_of_literals, size_t guard) {
+	if (guard != SAT_NO_REASON) {
+		literals[num_of_literals] = guard;
+		num_of_literals++;
+	}
+	sat_add_clause(sat_solver, literals, num_of_literals);
+}
+
+// Tseitin encoding of one gate over the signal variables of one truth table row.
+void sat_encode_gate(sat_solver *sat_solver, gate_type type, input_output *IO, size_t first_var, size_t guard) {
 	size_t ONE = 1;
-	if (IO->num_of_inputs < 2 || IO->num_of_outputs != ONE) {
-		return false;
+	size_t *literals = malloc(sizeof(size_t) * (IO->num_of_inputs + IO->num_of_selectors + 3));
+	size_t a = first_var + ((IO->num_of_inputs > 0) ? IO->input_ids[0] : 0);
+	size_t b = first_var + ((IO->num_of_inputs > 1) ? IO->input_ids[1] : 0);
+	size_t o = first_var + ((IO->num_of_outputs > 0) ? IO->output_ids[0] : 0);
+	switch (type) {
+		case OR:
+			literals[0] = sat_literal(a, true);
+			literals[1] = sat_literal(o, false);
+			sat_add_gate_clause(sat_solver, literals, 2, guard);
+			literals[0] = sat_literal(b, true);
+			literals[1] = sat_literal(o, false);
+			sat_add_gate_clause(sat_solver, literals, 2, guard);
+			literals[0] = sat_literal(a, false);
+			literals[1] = sat_literal(b, false);
+			literals[2] = sat_literal(o, true);
+			sat_add_gate_clause(sat_solver, literals, 3, guard);
+			break;
+		case AND:
+			literals[0] = sat_literal(a, false);
+			literals[1] = sat_literal(o, true);
+			sat_add_gate_clause(sat_solver, literals, 2, guard);
+			literals[0] = sat_literal(b, false);
+			literals[1] = sat_literal(o, true);
+			sat_add_gate_clause(sat_solver, literals, 2, guard);
+			literals[0] = sat_literal(a, true);
+			literals[1] = sat_literal(b, true);
+			literals[2] = sat_literal(o, false);
+			sat_add_gate_clause(sat_solver, literals, 3, guard);
+			break;
+		case XOR:
+			for (size_t i = 0; i < 4; i++) {
+				bool is_a_negated = (i & 1) != 0;
+				bool is_b_negated = (i & 2) != 0;
+				literals[0] = sat_literal(a, is_a_negated);
+				literals[1] = sat_literal(b, is_b_negated);
+				literals[2] = sat_literal(o, is_a_negated == is_b_negated);
+				sat_add_gate_clause(sat_solver, literals, 3, guard);
+			}
+			break;
+		case NOT:
+			literals[0] = sat_literal(a, false);
+			literals[1] = sat_literal(o, false);
+			sat_add_gate_clause(sat_solver, literals, 2, guard);
+			literals[0] = sat_literal(a, true);
+			literals[1] = sat_literal(o, true);
+			sat_add_gate_clause(sat_solver, literals, 2, guard);
+			break;
+		case DECODER: {
+			size_t num_of_bits = IO->num_of_inputs;
+			outcomes *outcomes = outcomes_builder(num_of_bits);
+			for (size_t i = 0; i < outcomes->num_of_outcomes; i++) {
+				size_t output = first_var + IO->output_ids[i];
+				for (size_t j = 0; j < num_of_bits; j++) {
+					bool bit = ((outcomes->outcomes[i] >> (num_of_bits - ONE - j)) & ONE) != 0;
+					literals[0] = sat_literal(output, true);
+					literals[1] = sat_literal(first_var + IO->input_ids[j], !bit);
+					sat_add_gate_clause(sat_solver, literals, 2, guard);
+				}
+				for (size_t j = 0; j < num_of_bits; j++) {
+					bool bit = ((outcomes->outcomes[i] >> (num_of_bits - ONE - j)) & ONE) != 0;
+					literals[j] = sat_literal(first_var + IO->input_ids[j], bit);
+				}
+				literals[num_of_bits] = sat_literal(output, false);
+				sat_add_gate_clause(sat_solver, literals, num_of_bits + 1, guard);
+			}
+			outcomes = outcomes_free(outcomes, false);
+			break;
+		}
+		case MULTIPLEXER: {
+			size_t num_of_bits = IO->num_of_selectors;
+			size_t *selector_ids = IO->selector_ids;
+			if (num_of_bits == 0) {
+				num_of_bits = get_number_of_selectors(IO->num_of_inputs);
+				selector_ids = IO->input_ids + IO->num_of_inputs - num_of_bits;
+			}
+			outcomes *outcomes = outcomes_builder(num_of_bits);
+			for (size_t i = 0; i < outcomes->num_of_outcomes; i++) {
+				for (size_t j = 0; j < num_of_bits; j++) {
+					bool bit = ((outcomes->outcomes[i] >> (num_of_bits - ONE - j)) & ONE) != 0;
+					literals[j] = sat_literal(first_var + selector_ids[j], bit);
+				}
+				for (size_t j = 0; j < 2; j++) {
+					literals[num_of_bits] = sat_literal(first_var + IO->input_ids[i], j == 0);
+					literals[num_of_bits + 1] = sat_literal(o, j != 0);
+					sat_add_gate_clause(sat_solver, literals, num_of_bits + 2, guard);
+				}
+			}
+			outcomes = outcomes_free(outcomes, false);
+			break;
+		}
+		default:
+			break;
 	}
-	size_t num_of_inputs = IO->num_of_inputs;
-	size_t num_of_selectors = IO->num_of_selectors;
-	size_t test_num_of_selectors = get_number_of_selectors(IO->num_of_inputs);
-	size_t access_back = 0;
-	if (num_of_selectors == 0) {
-		if (test_num_of_selectors == 0) {
-			return false;
-		} else {
-			num_of_selectors = test_num_of_selectors;
-			access_back = 1;
+	literals = Free(literals);
+}
+
+// Checks that the netlist means the same thing as a formula as it does to the simulator: every
+// gate fits its pins, signals are driven once and before they are read, no gate reads a driven primary
+// output (the simulator reads those as 0), and every MUX has 2^s data pins.
+bool sat_search_is_applicable(circuit *circuit, input_value *input_value) {
+	size_t ONE = 1;
+	size_t num_of_signals = input_value->num_of_signals;
+	size_t num_of_fixed_signals = input_value->original_num_of_inputs + 2;
+	bool *is_driven = calloc(num_of_signals, sizeof(bool));
+	bool *is_defined = calloc(num_of_signals, sizeof(bool));
+	bool is_applicable = true;
+	for (size_t i = 0; i < num_of_fixed_signals && i < num_of_signals; i++) {
+		is_driven[i] = true;
+		is_defined[i] = true;
+	}
+	for (size_t k = 0; k < circuit->num_of_gates; k++) {
+		input_output *IO = circuit->gates[k]->input_output;
+		for (size_t i = 0; i < IO->num_of_outputs; i++) {
+			if (is_driven[IO->output_ids[i]]) {
+				is_applicable = false;
+			}
+			is_driven[IO->output_ids[i]] = true;
 		}
 	}
-	size_t num_of_bits = num_of_selectors;
-	outcomes *outcomes = outcomes_builder(num_of_bits);
-	size_t num_of_outcomes = outcomes->num_of_outcomes;
-	for (size_t i = 0; i < num_of_outcomes; i++) {
-		size_t correct = 1;
-		size_t bit_counter = num_of_bits - ONE;
-		for (size_t j = 0, k = num_of_inputs - num_of_bits; j < num_of_bits; j++, k++) {
-			char *selector = NULL;
-			if (access_back == 1) {
-				selector = IO->inputs[k];
-			} else {
-				selector = IO->selectors[j];
+	size_t z = 0;
+	for (size_t k = 0; k < circuit->num_of_gates && is_applicable; k++) {
+		gate *gate = circuit->gates[k];
+		input_output *IO = gate->input_output;
+		if (z < circuit->num_of_other_gates && circuit->other_gate_indices[z] == k) {
+			z++;
+		} else if (!gate_type_fits_arity(gate->type, IO)) {
+			is_applicable = false;
+		}
+		if (gate->type == MULTIPLEXER && IO->num_of_selectors != 0 && (IO->num_of_selectors >= 64 || IO->num_of_inputs != (ONE << IO->num_of_selectors))) {
+			is_applicable = false;
+		}
+		for (size_t i = 0; i < IO->num_of_inputs; i++) {
+			if (is_driven[IO->input_ids[i]] && !is_defined[IO->input_ids[i]]) {
+				is_applicable = false;
 			}
-			if (get_value_of_input_var(selector, input_value) != (outcomes->outcomes[i] & (ONE << bit_counter)) >> bit_counter) {
-				correct = 0;
-				break;
+		}
+		for (size_t i = 0; i < IO->num_of_selectors; i++) {
+			if (is_driven[IO->selector_ids[i]] && !is_defined[IO->selector_ids[i]]) {
+				is_applicable = false;
 			}
-			bit_counter--;
 		}
-		if (correct == 0) {
-			continue;
+		for (size_t i = 0; i < IO->num_of_outputs; i++) {
+			is_defined[IO->output_ids[i]] = IO->output_slots[i] == NO_OUTPUT_SLOT;
+		}
+	}
+	is_driven = Free(is_driven);
+	is_defined = Free(is_defined);
+	return is_applicable;
+}
+
+// Adds one copy of the circuit for a single truth table row, with the primary inputs and final
+// outputs fixed to that row. Signals nothing drives read as 0, as they do in the simulator, and so does
+// a final output no gate publishes to, even when it names a primary input or a constant.
+void sat_encode_row(sat_solver *sat_solver, circuit *circuit, input_value *input_value, output_value *output_value, size_t *choice_vars, size_t row) {
+	size_t ONE = 1;
+	size_t num_of_bits = input_value->original_num_of_inputs;
+	size_t num_of_signals = input_value->num_of_signals;
+	size_t num_of_padded_words = input_value->num_of_blocks * input_value->num_of_block_words;
+	size_t first_var = sat_solver->num_of_vars;
+	for (size_t i = 0; i < num_of_signals; i++) {
+		sat_solver_new_var(sat_solver);
+	}
+	bool *is_driven = calloc(num_of_signals, sizeof(bool));
+	size_t *output_signal_ids = malloc(sizeof(size_t) * (output_value->num_of_outputs + 1));
+	for (size_t i = 0; i < output_value->num_of_outputs; i++) {
+		output_signal_ids[i] = SIZE_MAX;
+	}
+	for (size_t i = 0; i < num_of_bits + 2; i++) {
+		bool bit = (i < num_of_bits) ? ((input_value->input_words[i * num_of_padded_words + row / 64] >> (row % 64)) & ONE) != 0 : input_value->inputs[i]->value != 0;
+		size_t literal = sat_literal(first_var + i, !bit);
+		sat_add_clause(sat_solver, &literal, 1);
+		is_driven[i] = true;
+	}
+	size_t z = 0;
+	for (size_t k = 0; k < circuit->num_of_gates; k++) {
+		gate *gate = circuit->gates[k];
+		input_output *IO = gate->input_output;
+		for (size_t i = 0; i < IO->num_of_outputs; i++) {
+			is_driven[IO->output_ids[i]] = true;
+			if (IO->output_slots[i] != NO_OUTPUT_SLOT) {
+				output_signal_ids[IO->output_slots[i]] = IO->output_ids[i];
+			}
 		}
-		if (output_var_is_final(IO->outputs[0], output_value)) {
-			update_final_output_var(IO->outputs[0], get_value_of_input_var(IO->inputs[i], input_value), index_of_input_permu, output_value);
+		if (z < circuit->num_of_other_gates && circuit->other_gate_indices[z] == k) {
+			for (size_t t = 0; t < circuit->num_of_feasible_gate_types[z]; t++) {
+				gate_type type = circuit->feasible_gate_types[z * GATE_COUNT + t];
+				sat_encode_gate(sat_solver, type, IO, first_var, sat_literal(choice_vars[z * GATE_COUNT + t], true));
+			}
+			z++;
 		} else {
-			add_output_to_inputs(IO->outputs[0], get_value_of_input_var(IO->inputs[i], input_value), input_value);
+			sat_encode_gate(sat_solver, gate->type, IO, first_var, SAT_NO_REASON);
 		}
-		break;
 	}
-	outcomes = outcomes_free(outcomes, false);
-	return true;
+	for (size_t i = 0; i < num_of_signals; i++) {
+		if (!is_driven[i]) {
+			size_t literal = sat_literal(first_var + i, true);
+			sat_add_clause(sat_solver, &literal, 1);
+		}
+	}
+	for (size_t i = 0; i < output_value->num_of_outputs; i++) {
+		size_t signal_id = output_signal_ids[i];
+		bool bit = ((output_value->outputs[i]->words[row / 64] >> (row % 64)) & ONE) != 0;
+		if (signal_id == SIZE_MAX) {
+			if (bit) {
+				sat_add_clause(sat_solver, NULL, 0);
+			}
+			continue;
+		}
+		size_t literal = sat_literal(first_var + signal_id, !bit);
+		sat_add_clause(sat_solver, &literal, 1);
+	}
+	output_signal_ids = Free(output_signal_ids);
+	is_driven = Free(is_driven);
 }
 
+// Simulates the current gate types over the whole truth table and returns the first wrong row, if any.
+size_t find_mismatch_row(circuit *circuit, input_value *input_value, output_value *output_value) {
+	size_t row = SIZE_MAX;
+	bytecode_load_types(circuit->bytecode, circuit->gates);
+	for (size_t j = 0; j < input_value->num_of_blocks; j++) {
+		if (!evaluate_gates(circuit->bytecode, input_value, output_value, j)) {
+			row = (output_value->mismatch_row == SIZE_MAX) ? 0 : output_value->mismatch_row;
+			break;
+		}
+	}
+	output_value->mismatch_row = SIZE_MAX;
+	reset_output_value(output_value);
+	return row;
+}
+
+// Counterexample-guided loop: solve over the rows encoded so far, simulate the model on the full
+// truth table, and encode the first row it gets wrong until a model passes or none is left.
+bool sat_solve_with_refinement(sat_solver *sat_solver, circuit *circuit, input_value *input_value, output_value *output_value, size_t *choice_vars, uint64_t *encoded_rows, size_t assumption, bool *is_consistent) {
+	while (sat_solve(sat_solver, assumption)) {
+		for (size_t z = 0; z < circuit->num_of_other_gates; z++) {
+			for (size_t t = 0; t < circuit->num_of_feasible_gate_types[z]; t++) {
+				if (sat_solver->model[choice_vars[z * GATE_COUNT + t]] == 1) {
+					circuit->gates[circuit->other_gate_indices[z]]->type = circuit->feasible_gate_types[z * GATE_COUNT + t];
+				}
+			}
+		}
+		size_t row = find_mismatch_row(circuit, input_value, output_value);
+		if (row == SIZE_MAX) {
+			return true;
+		}
+		if ((encoded_rows[row / 64] >> (row % 64)) & 1) {
+			*is_consistent = false;
+			return false;
+		}
+		encoded_rows[row / 64] |= (uint64_t) 1 << (row % 64);
+		sat_encode_row(sat_solver, circuit, input_value, output_value, choice_vars, row);
+	}
+	return false;
+}
 
+// Finds the same assignment as the enumerating search, the first valid one in its order, by fixing the
+// unknown gates one at a time to the lowest type for which a valid completion still exists.
+bool sat_search(circuit *circuit, input_value *input_value, output_value *output_value) {
+	size_t num_of_other_gates = circuit->num_of_other_gates;
+	size_t num_of_padded_words = input_value->num_of_blocks * input_value->num_of_block_words;
+	sat_solver *sat_solver = sat_solver_constructor();
+	size_t *choice_vars = malloc(sizeof(size_t) * (num_of_other_gates * GATE_COUNT + 1));
+	size_t *literals = malloc(sizeof(size_t) * GATE_COUNT);
+	for (size_t z = 0; z < num_of_other_gates; z++) {
+		size_t num_of_types = circuit->num_of_feasible_gate_types[z];
+		for (size_t t = 0; t < num_of_types; t++) {
+			choice_vars[z * GATE_COUNT + t] = sat_solver_new_var(sat_solver);
+			literals[t] = sat_literal(choice_vars[z * GATE_COUNT + t], false);
+		}
+		sat_add_clause(sat_solver, literals, num_of_types);
+		for (size_t t = 0; t < num_of_types; t++) {
+			for (size_t u = t + 1; u < num_of_types; u++) {
+				literals[0] = sat_literal(choice_vars[z * GATE_COUNT + t], true);
+				literals[1] = sat_literal(choice_vars[z * GATE_COUNT + u], true);
+				sat_add_clause(sat_solver, literals, 2);
+			}
+		}
+	}
+	uint64_t *encoded_rows = calloc(num_of_padded_words, sizeof(uint64_t));
+	encoded_rows[0] = 1;
+	sat_encode_row(sat_solver, circuit, input_value, output_value, choice_vars, 0);
+	bool is_consistent = true;
+	bool correct_output = true;
+	if (num_of_other_gates == 0) {
+		correct_output = sat_solve_with_refinement(sat_solver, circuit, input_value, output_value, choice_vars, encoded_rows, SAT_NO_REASON, &is_consistent);
+	}
+	for (size_t z = 0; z < num_of_other_gates && correct_output && is_consistent; z++) {
+		bool is_fixed = false;
+		for (size_t t = 0; t < circuit->num_of_feasible_gate_types[z] && !is_fixed && is_consistent; t++) {
+			size_t literal = sat_literal(choice_vars[z * GATE_COUNT + t], false);
+			is_fixed = sat_solve_with_refinement(sat_solver, circuit, input_value, output_value, choice_vars, encoded_rows, literal, &is_consistent);
+			literal ^= is_fixed ? 0 : 1;
+			sat_add_clause(sat_solver, &literal, 1);
+		}
+		correct_output = is_fixed;
+	}
+	encoded_rows = Free(encoded_rows);
+	literals = Free(literals);
+	choice_vars = Free(choice_vars);
+	sat_solver = sat_solver_free(sat_solver, false);
+	if (!is_consistent) {
+		return sequential_search(circuit, input_value, output_value, get_num_of_assignments(circuit));
+	}
+	return correct_output;
+}